@@ -0,0 +1,88 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/17/2026
+ *
+ * This file contains functions for building and measuring axis aligned
+ * bounding boxes.
+ */
+
+/* Header file for this source file. */
+#include "bbox.h"
+
+/*
+ * Resets a box so that any point added to it will become its only content.
+ * Param: box  The box to reset.
+ */
+void box_empty(bbox_t* box)
+{
+    for (int i = 0; i < XYZ; i++)
+    {
+        box->min[i] = HUGE_VAL;
+        box->max[i] = -HUGE_VAL;
+    }
+}
+
+/*
+ * Grows a box to contain a point.
+ * Param: box  The box to grow.
+ * Param: point  The point to include.
+ */
+void box_add_point(bbox_t* box, real_t* point)
+{
+    for (int i = 0; i < XYZ; i++)
+    {
+        box->min[i] = point[i] < box->min[i] ? point[i] : box->min[i];
+        box->max[i] = point[i] > box->max[i] ? point[i] : box->max[i];
+    }
+}
+
+/*
+ * Grows a box to contain another box.
+ * Param: box  The box to grow.
+ * Param: other  The box to include.
+ */
+void box_add_box(bbox_t* box, bbox_t* other)
+{
+    box_add_point(box, other->min);
+    box_add_point(box, other->max);
+}
+
+/*
+ * Grows a box to contain a flat disc. A disc facing along a unit axis reaches
+ * radius * sqrt(1 - axis[i]^2) from its center along world axis i.
+ *
+ * Param: box  The box to grow.
+ * Param: center  The center of the disc.
+ * Param: axis  The unit vector the disc faces along.
+ * Param: radius  The radius of the disc.
+ */
+void box_add_disc(bbox_t* box, real_t* center, real_t* axis, real_t radius)
+{
+    real_t low[XYZ];
+    real_t high[XYZ];
+    for (int i = 0; i < XYZ; i++)
+    {
+        real_t spread = 1.0 - axis[i] * axis[i];
+        real_t reach = radius * sqrt(spread > 0 ? spread : 0);
+        low[i] = center[i] - reach;
+        high[i] = center[i] + reach;
+    }
+    box_add_point(box, low);
+    box_add_point(box, high);
+}
+
+/*
+ * Finds the surface area of a box.
+ * Param: box  The box to measure.
+ * Return: The surface area, or 0 for an empty box.
+ */
+real_t box_area(bbox_t* box)
+{
+    real_t d[XYZ];
+    diff3(box->min, box->max, d);
+    if (d[X] < 0 || d[Y] < 0 || d[Z] < 0)
+    {
+        return 0.0;
+    }
+    return 2.0 * (d[X] * d[Y] + d[Y] * d[Z] + d[Z] * d[X]);
+}
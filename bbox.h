@@ -0,0 +1,40 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/17/2026
+ *
+ * This is the header file for the bbox.c source file. It contains the axis
+ * aligned bounding box type that every object type reports its extent with.
+ */
+
+/* Ensures this header file is only included once. */
+#pragma once
+
+/* Included for the vector functions and the XYZ define. */
+#include "veclib.h"
+
+/* Returned by the bounds functions for objects with no finite extent. */
+#define UNBOUNDED 0
+/* Returned by the bounds functions once the output box has been set. */
+#define BOUNDED   1
+
+/*
+ * An axis aligned bounding box in world coordinates.
+ *
+ * Data Member: min  The lowest corner of the box.
+ * Data Member: max  The highest corner of the box.
+ */
+typedef struct bbox_type
+{
+    real_t min[XYZ];
+    real_t max[XYZ];
+} bbox_t;
+
+void box_empty(bbox_t* box);
+
+void box_add_point(bbox_t* box, real_t* point);
+
+void box_add_box(bbox_t* box, bbox_t* other);
+
+void box_add_disc(bbox_t* box, real_t* center, real_t* axis, real_t radius);
+
+real_t box_area(bbox_t* box);
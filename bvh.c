@@ -0,0 +1,738 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/17/2026
+ *
+ * This file contains logic for building a bounding volume hierarchy over the
+ * scene, split using the surface area heuristic, and for finding the closest
+ * object along a ray with it. The search returns exactly what the linear
+ * scan in raytrace.c would return, including which object wins a tie.
+ */
+
+/* Header file for this source file. */
+#include "bvh.h"
+/* Included for the object_bounds function. */
+#include "model.h"
+/* Included for the plane_t struct and distance kernel for unbounded planes. */
+#include "plane.h"
+/* Included for hit_epsilon. */
+#include "raytrace.h"
+
+/*
+ * Build time record for a single bounded object.
+ *
+ * Data Member: box  The bounds of the object.
+ * Data Member: centroid  The center of box, used to choose splits.
+ * Data Member: obj  The object itself.
+ * Data Member: order  The id of the object, which follows the scene file.
+ */
+typedef struct bvh_prim_type
+{
+    bbox_t box;
+    real_t centroid[XYZ];
+    obj_t* obj;
+    int order;
+} bvh_prim_t;
+
+/*
+ * Running state for a single closest object query.
+ *
+ * Data Member: base  The starting point of the ray.
+ * Data Member: dir   The direction of the ray.
+ * Data Member: last_hit  The object to skip.
+ * Data Member: closest   The closest object found so far.
+ * Data Member: order     The scene position of closest.
+ * Data Member: mindist   The distance to closest.
+ * Data Member: min_dist  The distance below which hits are ignored.
+ */
+typedef struct bvh_query_type
+{
+    real_t* base;
+    real_t* dir;
+    obj_t* last_hit;
+    obj_t* closest;
+    int order;
+    real_t* mindist;
+    real_t min_dist;
+} bvh_query_t;
+
+/*
+ * Finds the bounds of an object and pads them so that rounding in the hits
+ * functions can't land a hit just outside the box.
+ *
+ * Param: obj  The object to bound.
+ * Param: box  The output box.
+ *
+ * Return: BOUNDED if box was set, UNBOUNDED otherwise.
+ */
+static int padded_bounds(obj_t* obj, bbox_t* box)
+{
+    if (object_bounds(obj, box) == UNBOUNDED)
+    {
+        return UNBOUNDED;
+    }
+    for (int i = 0; i < XYZ; i++)
+    {
+        real_t pad = BVH_PAD * (fabs(box->min[i]) + fabs(box->max[i]) + 1.0);
+        box->min[i] -= pad;
+        box->max[i] += pad;
+    }
+    return BOUNDED;
+}
+
+/*
+ * The relative cost of testing an object in a leaf. Spheres are tested
+ * a vector at a time, so each costs a share of one test.
+ *
+ * Param: obj  The object to cost.
+ * Return: The cost against one scalar test.
+ */
+static real_t bvh_test_cost(obj_t* obj)
+{
+    return bvh_is_batched(obj) ? 1.0 / (real_t)sbatch_width() : 1.0;
+}
+
+/*
+ * Recursively builds the nodes over prims[start, end) using binned SAH.
+ *
+ * Param: bvh  The hierarchy being built.
+ * Param: prims  The build records, reordered in place.
+ * Param: start  The first record of this node.
+ * Param: end    One past the last record of this node.
+ * Param: depth  The depth of this node in the tree.
+ *
+ * Return: The index of the node that was built.
+ */
+static int bvh_build_node(bvh_t* bvh, bvh_prim_t* prims, int start, int end,
+                          int depth)
+{
+    int index = bvh->num_nodes++;
+    bvh_node_t* node = &bvh->nodes[index];
+    int count = end - start;
+    bbox_t cbox;
+    box_empty(&node->box);
+    box_empty(&cbox);
+    for (int i = start; i < end; i++)
+    {
+        box_add_box(&node->box, &prims[i].box);
+        box_add_point(&cbox, prims[i].centroid);
+    }
+    /* Splits along the axis the centroids are most spread out on. */
+    int axis = X;
+    for (int i = Y; i < XYZ; i++)
+    {
+        if (cbox.max[i] - cbox.min[i] > cbox.max[axis] - cbox.min[axis])
+        {
+            axis = i;
+        }
+    }
+    real_t extent = cbox.max[axis] - cbox.min[axis];
+    int mid = start;
+    if (depth >= BVH_MAX_DEPTH)
+    {
+        /* Too deep to split again without overflowing the traversal stack. */
+        mid = start;
+    }
+    else if (count > 1 && extent > 0)
+    {
+        int counts[BVH_BUCKETS] = {0};
+        real_t costs[BVH_BUCKETS] = {0};
+        real_t leaf_cost = 0;
+        bbox_t boxes[BVH_BUCKETS];
+        for (int b = 0; b < BVH_BUCKETS; b++)
+        {
+            box_empty(&boxes[b]);
+        }
+        for (int i = start; i < end; i++)
+        {
+            int b = (int)(BVH_BUCKETS *
+                          (prims[i].centroid[axis] - cbox.min[axis]) / extent);
+            b = b >= BVH_BUCKETS ? BVH_BUCKETS - 1 : b;
+            counts[b]++;
+            costs[b] += bvh_test_cost(prims[i].obj);
+            leaf_cost += bvh_test_cost(prims[i].obj);
+            box_add_box(&boxes[b], &prims[i].box);
+        }
+        /* Cost of splitting after each bucket, relative to this node. */
+        real_t best_cost = HUGE_VAL;
+        int best_split = 0;
+        for (int s = 0; s < BVH_BUCKETS - 1; s++)
+        {
+            bbox_t left, right;
+            int nleft = 0, nright = 0;
+            real_t cleft = 0, cright = 0;
+            box_empty(&left);
+            box_empty(&right);
+            for (int b = 0; b <= s; b++)
+            {
+                box_add_box(&left, &boxes[b]);
+                nleft += counts[b];
+                cleft += costs[b];
+            }
+            for (int b = s + 1; b < BVH_BUCKETS; b++)
+            {
+                box_add_box(&right, &boxes[b]);
+                nright += counts[b];
+                cright += costs[b];
+            }
+            real_t cost = BVH_TRAVERSE_COST +
+                          (cleft * box_area(&left) +
+                           cright * box_area(&right)) / box_area(&node->box);
+            if (nleft && nright && cost < best_cost)
+            {
+                best_cost = cost;
+                best_split = s;
+            }
+        }
+        if (best_cost < leaf_cost || count > BVH_MAX_LEAF)
+        {
+            /* Partitions the records around the chosen bucket. */
+            mid = start;
+            for (int i = start; i < end; i++)
+            {
+                int b = (int)(BVH_BUCKETS *
+                         (prims[i].centroid[axis] - cbox.min[axis]) / extent);
+                b = b >= BVH_BUCKETS ? BVH_BUCKETS - 1 : b;
+                if (b <= best_split)
+                {
+                    bvh_prim_t temp = prims[i];
+                    prims[i] = prims[mid];
+                    prims[mid] = temp;
+                    mid++;
+                }
+            }
+        }
+    }
+    else if (count > BVH_MAX_LEAF)
+    {
+        /* All centroids coincide, so any even split is as good as another. */
+        mid = start + count / 2;
+    }
+    if (mid == start || mid == end)
+    {
+        node->offset = start;
+        node->count = count;
+        node->axis = axis;
+        node->spheres = 0;
+    }
+    else
+    {
+        bvh_build_node(bvh, prims, start, mid, depth + 1);
+        int right = bvh_build_node(bvh, prims, mid, end, depth + 1);
+        /* Node pointer may not be trusted across the recursive calls. */
+        node = &bvh->nodes[index];
+        node->offset = right;
+        node->count = 0;
+        node->axis = axis;
+        node->spheres = 0;
+    }
+    return index;
+}
+
+/*
+ * Decides if an object is an infinite plane that can be tested with
+ * plane_distance. Finite planes share plane_t but are bounded, so they go
+ * into the tree instead.
+ *
+ * Param: obj  The object to check.
+ * Return: TRUE for planes, tiled planes and procedural planes.
+ */
+int bvh_is_plane(obj_t* obj)
+{
+    return obj->objtype == PLANE || obj->objtype == P_PLANE ||
+           obj->objtype == TILED_PLANE;
+}
+
+/*
+ * Decides if an object is a plain sphere, which can be tested from the
+ * sphere batch instead of through its hits function.
+ *
+ * Param: obj  The object to check.
+ * Return: TRUE for spheres.
+ */
+int bvh_is_batched(obj_t* obj)
+{
+    return obj->objtype == SPHERE;
+}
+
+/*
+ * Moves the spheres of a leaf to its start, each part in scene order, so the
+ * first of two equally near spheres in the batch is also first in the scene.
+ *
+ * Param: prims  The build records.
+ * Param: node   The leaf to sort.
+ */
+static void bvh_sort_leaf(bvh_prim_t* prims, bvh_node_t* node)
+{
+    bvh_prim_t* leaf = &prims[node->offset];
+    for (int i = 1; i < node->count; i++)
+    {
+        bvh_prim_t temp = leaf[i];
+        int batched = bvh_is_batched(temp.obj);
+        int j = i;
+        while (j > 0 && (batched > bvh_is_batched(leaf[j - 1].obj) ||
+                         (batched == bvh_is_batched(leaf[j - 1].obj) &&
+                          temp.order < leaf[j - 1].order)))
+        {
+            leaf[j] = leaf[j - 1];
+            j--;
+        }
+        leaf[j] = temp;
+    }
+    while (node->spheres < node->count &&
+           bvh_is_batched(leaf[node->spheres].obj))
+    {
+        node->spheres++;
+    }
+}
+
+/*
+ * Builds a bounding volume hierarchy over every object in a scene store.
+ * Objects are ordered by their ids, which follow the scene file, so ties
+ * are broken the same way whatever order the store groups them in.
+ *
+ * Param: scene  The store of scene objects.
+ *
+ * Return: The constructed hierarchy.
+ */
+bvh_t* bvh_build(store_t* scene)
+{
+    bvh_t* bvh = Malloc(sizeof(bvh_t));
+    int total = scene->count;
+    bvh_prim_t* prims = Malloc(sizeof(bvh_prim_t) * (size_t)(total + 1));
+    bvh->unbounded = Malloc(sizeof(obj_t*) * (size_t)(total + 1));
+    bvh->unbounded_order = Malloc(sizeof(int) * (size_t)(total + 1));
+    bvh->planes = Malloc(sizeof(bvh_plane_t) * (size_t)(total + 1));
+    bvh->num_unbounded = 0;
+    bvh->num_planes = 0;
+    bvh->num_prims = 0;
+    for (int i = 0; i < total; i++)
+    {
+        obj_t* node = &scene->objs[i];
+        int order = node->objid;
+        bvh_prim_t* prim = &prims[bvh->num_prims];
+        if (bvh_is_plane(node))
+        {
+            bvh_plane_t* plane = &bvh->planes[bvh->num_planes];
+            plane->plane = (plane_t*)node->priv;
+            plane->obj = node;
+            plane->order = order;
+            bvh->num_planes++;
+        }
+        else if (padded_bounds(node, &prim->box) == BOUNDED)
+        {
+            sum3(prim->box.min, prim->box.max, prim->centroid);
+            scale3(0.5, prim->centroid, prim->centroid);
+            prim->obj = node;
+            prim->order = order;
+            bvh->num_prims++;
+        }
+        else
+        {
+            bvh->unbounded[bvh->num_unbounded] = node;
+            bvh->unbounded_order[bvh->num_unbounded] = order;
+            bvh->num_unbounded++;
+        }
+    }
+    bvh->nodes = Malloc(sizeof(bvh_node_t) * (size_t)(2 * bvh->num_prims + 1));
+    bvh->num_nodes = 0;
+    bvh->prims = Malloc(sizeof(obj_t*) * (size_t)(bvh->num_prims + 1));
+    bvh->prim_order = Malloc(sizeof(int) * (size_t)(bvh->num_prims + 1));
+    if (bvh->num_prims)
+    {
+        bvh_build_node(bvh, prims, 0, bvh->num_prims, 0);
+    }
+    for (int i = 0; i < bvh->num_nodes; i++)
+    {
+        if (bvh->nodes[i].count)
+        {
+            bvh_sort_leaf(prims, &bvh->nodes[i]);
+        }
+    }
+    bvh->spheres = sbatch_init(bvh->num_prims);
+    for (int i = 0; i < bvh->num_prims; i++)
+    {
+        bvh->prims[i] = prims[i].obj;
+        bvh->prim_order[i] = prims[i].order;
+        if (bvh_is_batched(prims[i].obj))
+        {
+            sbatch_set(bvh->spheres, i, (sphere_t*)prims[i].obj->priv);
+        }
+    }
+    free(prims);
+    return bvh;
+}
+
+/*
+ * Finds where a ray enters a box.
+ *
+ * Param: box   The box to test.
+ * Param: base  The starting point of the ray.
+ * Param: dir   The direction of the ray, which need not be a unit vector.
+ * Param: tnear Output for the distance along dir at which the ray enters
+ *              the box, or 0 if it starts inside.
+ *
+ * Return: 1 if the ray touches the box, 0 otherwise.
+ */
+int ray_box(bbox_t* box, real_t* base, real_t* dir, real_t* tnear)
+{
+    STAT_BOX();
+    real_t t0 = 0.0;
+    real_t t1 = HUGE_VAL;
+    for (int i = 0; i < XYZ; i++)
+    {
+        if (dir[i] == 0)
+        {
+            if (base[i] < box->min[i] || base[i] > box->max[i])
+            {
+                return 0;
+            }
+            continue;
+        }
+        real_t inv = 1.0 / dir[i];
+        real_t tmin = (box->min[i] - base[i]) * inv;
+        real_t tmax = (box->max[i] - base[i]) * inv;
+        if (tmin > tmax)
+        {
+            real_t temp = tmin;
+            tmin = tmax;
+            tmax = temp;
+        }
+        t0 = tmin > t0 ? tmin : t0;
+        t1 = tmax < t1 ? tmax : t1;
+        if (t0 > t1)
+        {
+            return 0;
+        }
+    }
+    *tnear = t0;
+    return 1;
+}
+
+/*
+ * Decides if a hit beats the closest one found so far. Ties go to the object
+ * that comes first in the scene file, as they do in the scan.
+ *
+ * Param: query  The running query.
+ * Param: dist   The distance to the new hit.
+ * Param: order  The scene position of the object hit.
+ *
+ * Return: TRUE if the new hit should replace the closest.
+ */
+static int bvh_closer(bvh_query_t* query, real_t dist, int order)
+{
+    return dist >= query->min_dist &&
+           (*query->mindist == MISS || dist < *query->mindist ||
+            (dist == *query->mindist && order < query->order));
+}
+
+/*
+ * Tests a single object and keeps it if it is the new closest.
+ *
+ * Param: query  The running query.
+ * Param: obj    The object to test.
+ * Param: order  The scene position of obj.
+ */
+static void bvh_test(bvh_query_t* query, obj_t* obj, int order)
+{
+    if (obj == query->last_hit)
+    {
+        return;
+    }
+    real_t dist = obj->hits(query->base, query->dir, obj);
+    STAT_TEST(obj->objtype, dist >= query->min_dist);
+    if (bvh_closer(query, dist, order))
+    {
+        *query->mindist = dist;
+        query->closest = obj;
+        query->order = order;
+    }
+}
+
+/*
+ * Finds which slot of a leaf's spheres holds the object a ray is leaving.
+ *
+ * Param: bvh  The hierarchy being searched.
+ * Param: node The leaf.
+ * Param: last_hit  The object to find.
+ *
+ * Return: The slot in prims, or -1 if last_hit is not one of the spheres.
+ */
+static int bvh_sphere_slot(bvh_t* bvh, bvh_node_t* node, obj_t* last_hit)
+{
+    for (int i = node->offset; i < node->offset + node->spheres; i++)
+    {
+        if (bvh->prims[i] == last_hit)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/*
+ * Tests the spheres of a leaf as a batch and keeps the nearest if it is the
+ * new closest.
+ *
+ * Param: query  The running query.
+ * Param: bvh    The hierarchy being searched.
+ * Param: node   The leaf.
+ */
+static void bvh_test_spheres(bvh_query_t* query, bvh_t* bvh, bvh_node_t* node)
+{
+    int skip = bvh_sphere_slot(bvh, node, query->last_hit);
+    int hits;
+    real_t dist;
+    int slot = sbatch_nearest(bvh->spheres, node->offset,
+                              node->offset + node->spheres, query->base,
+                              query->dir, skip, query->min_dist, &dist,
+                              &hits);
+    STAT_TESTS(SPHERE, node->spheres - (skip >= 0), hits);
+    if (slot >= 0 && bvh_closer(query, dist, bvh->prim_order[slot]))
+    {
+        *query->mindist = dist;
+        query->closest = bvh->prims[slot];
+        query->order = bvh->prim_order[slot];
+    }
+}
+
+/*
+ * Tests an infinite plane and keeps it if it is the new closest.
+ *
+ * Param: query  The running query.
+ * Param: plane  The plane to test.
+ * Param: start  The starting point of the ray.
+ * Param: d      The unit direction of the ray.
+ */
+static void bvh_test_plane(bvh_query_t* query, bvh_plane_t* plane,
+                           vec3_t start, vec3_t d)
+{
+    if (plane->obj == query->last_hit)
+    {
+        return;
+    }
+    real_t dist = plane_distance(plane->plane, start, d);
+    STAT_TEST(plane->obj->objtype, dist >= query->min_dist);
+    if (bvh_closer(query, dist, plane->order))
+    {
+        *query->mindist = dist;
+        query->closest = plane->obj;
+        query->order = plane->order;
+    }
+}
+
+/*
+ * Finds the closest object along a ray using the hierarchy. The planes are
+ * tested first, so that a floor or wall behind the scene bounds the search
+ * before any box is opened. Only distances are compared during the search,
+ * and the hit record is filled in once for the winner.
+ *
+ * The hits functions for spheres and planes measure distance along the unit
+ * direction, while the quadrics measure it in multiples of dir. Boxes are
+ * therefore culled against the smaller of the two so that neither kind can
+ * be skipped when dir is not a unit vector.
+ *
+ * Param: bvh  The hierarchy to search.
+ * Param: base The starting point of the current ray.
+ * Param: dir  The direction of the current ray.
+ * Param: last_hit The last object that we hit.
+ * Param: mindist Output pointer that will hold the distance to the object.
+ * Param: hit  Output for the hit record of the closest object.
+ *
+ * Return: The closest object in the path of our ray (or NULL if no objects are
+ *         in our path).
+ */
+obj_t* bvh_closest_object(bvh_t* bvh, real_t* base, real_t* dir,
+                          obj_t* last_hit, real_t* mindist, hit_t* hit)
+{
+    bvh_query_t query = {base, dir, last_hit, NULL, 0, mindist,
+                         hit_epsilon(base)};
+    real_t len = length3(dir);
+    real_t cull = len < 1.0 ? len : 1.0;
+    int stack[BVH_STACK_SIZE];
+    int top = 0;
+    if (bvh->num_planes)
+    {
+        vec3_t start = vec3_load(base);
+        vec3_t d = vec3_unit(vec3_load(dir));
+        for (int i = 0; i < bvh->num_planes; i++)
+        {
+            bvh_test_plane(&query, &bvh->planes[i], start, d);
+        }
+    }
+    for (int i = 0; i < bvh->num_unbounded; i++)
+    {
+        bvh_test(&query, bvh->unbounded[i], bvh->unbounded_order[i]);
+    }
+    if (bvh->num_prims)
+    {
+        stack[top++] = 0;
+    }
+    while (top > 0)
+    {
+        bvh_node_t* node = &bvh->nodes[stack[--top]];
+        real_t tnear;
+        if (!ray_box(&node->box, base, dir, &tnear) ||
+            (*mindist != MISS && tnear * cull > *mindist))
+        {
+            continue;
+        }
+        if (node->count)
+        {
+            if (node->spheres)
+            {
+                bvh_test_spheres(&query, bvh, node);
+            }
+            for (int i = node->offset + node->spheres;
+                 i < node->offset + node->count; i++)
+            {
+                bvh_test(&query, bvh->prims[i], bvh->prim_order[i]);
+            }
+        }
+        else
+        {
+            int left = (int)(node - bvh->nodes) + 1;
+            /* Visits the nearer child first by pushing it last. */
+            if (dir[node->axis] > 0)
+            {
+                stack[top++] = node->offset;
+                stack[top++] = left;
+            }
+            else
+            {
+                stack[top++] = left;
+                stack[top++] = node->offset;
+            }
+        }
+    }
+    if (query.closest)
+    {
+        query.closest->cold->surface(base, dir, *mindist, query.closest, hit);
+    }
+    hit->t = *mindist;
+    hit->obj = query.closest;
+    return query.closest;
+}
+
+/*
+ * Finds any object that blocks a ray before maxdist, using the hierarchy.
+ * The search returns as soon as one is found, and skips every box that the
+ * ray only reaches beyond maxdist. Boxes are culled by the same rule as in
+ * bvh_closest_object, since maxdist is compared against the hits functions.
+ *
+ * Param: bvh  The hierarchy to search.
+ * Param: base The starting point of the current ray.
+ * Param: dir  The direction of the ray, towards the light.
+ * Param: last_hit The object the ray is leaving, which can't block it.
+ * Param: maxdist The distance past which objects no longer block the ray.
+ *
+ * Return: An object that blocks the ray, or NULL if nothing does.
+ */
+obj_t* bvh_occluder(bvh_t* bvh, real_t* base, real_t* dir, obj_t* last_hit,
+                    real_t maxdist)
+{
+    real_t len = length3(dir);
+    real_t cull = len < 1.0 ? len : 1.0;
+    real_t min_dist = hit_epsilon(base);
+    int stack[BVH_STACK_SIZE];
+    int top = 0;
+    if (bvh->num_planes)
+    {
+        vec3_t start = vec3_load(base);
+        vec3_t d = vec3_unit(vec3_load(dir));
+        for (int i = 0; i < bvh->num_planes; i++)
+        {
+            bvh_plane_t* plane = &bvh->planes[i];
+            if (plane->obj != last_hit)
+            {
+                real_t dist = plane_distance(plane->plane, start, d);
+                STAT_TEST(plane->obj->objtype, dist >= min_dist);
+                if (dist >= min_dist && dist <= maxdist)
+                {
+                    return plane->obj;
+                }
+            }
+        }
+    }
+    for (int i = 0; i < bvh->num_unbounded; i++)
+    {
+        obj_t* obj = bvh->unbounded[i];
+        if (obj != last_hit)
+        {
+            real_t dist = obj->hits(base, dir, obj);
+            STAT_TEST(obj->objtype, dist >= min_dist);
+            if (dist >= min_dist && dist <= maxdist)
+            {
+                return obj;
+            }
+        }
+    }
+    if (bvh->num_prims)
+    {
+        stack[top++] = 0;
+    }
+    while (top > 0)
+    {
+        bvh_node_t* node = &bvh->nodes[stack[--top]];
+        real_t tnear;
+        if (!ray_box(&node->box, base, dir, &tnear) || tnear * cull > maxdist)
+        {
+            continue;
+        }
+        if (node->count)
+        {
+            if (node->spheres)
+            {
+                int tests;
+                int hits;
+                int slot = sbatch_any(bvh->spheres, node->offset,
+                                      node->offset + node->spheres, base, dir,
+                                      bvh_sphere_slot(bvh, node, last_hit),
+                                      min_dist, maxdist, &tests, &hits);
+                STAT_TESTS(SPHERE, tests, hits);
+                if (slot >= 0)
+                {
+                    return bvh->prims[slot];
+                }
+            }
+            for (int i = node->offset + node->spheres;
+                 i < node->offset + node->count; i++)
+            {
+                obj_t* obj = bvh->prims[i];
+                if (obj != last_hit)
+                {
+                    real_t dist = obj->hits(base, dir, obj);
+                    STAT_TEST(obj->objtype, dist >= min_dist);
+                    if (dist >= min_dist && dist <= maxdist)
+                    {
+                        return obj;
+                    }
+                }
+            }
+        }
+        else
+        {
+            stack[top++] = node->offset;
+            stack[top++] = (int)(node - bvh->nodes) + 1;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Frees a hierarchy. The objects themselves still belong to the scene store.
+ * Param: bvh  The hierarchy to free.
+ */
+void bvh_free(bvh_t* bvh)
+{
+    if (bvh)
+    {
+        free(bvh->nodes);
+        free(bvh->prims);
+        free(bvh->prim_order);
+        sbatch_free(bvh->spheres);
+        free(bvh->unbounded);
+        free(bvh->unbounded_order);
+        free(bvh->planes);
+        free(bvh);
+    }
+}
@@ -0,0 +1,132 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/17/2026
+ *
+ * This is the header file for the bvh.c source file. It contains the bounding
+ * box and bounding volume hierarchy structures used to accelerate the search
+ * for the closest object along a ray.
+ */
+
+/* Ensures this header file is only included once. */
+#pragma once
+
+/* Includes the obj_t struct and the ROUNDING_ADJUSTMENT define. */
+#include "object.h"
+/* Includes the store_t struct that the hierarchy is built from. */
+#include "store.h"
+/* Includes the vector functions used when testing boxes. */
+#include "veclib.h"
+/* Includes the bbox_t struct that the hierarchy is made of. */
+#include "bbox.h"
+/* Includes the counters for intersection and box tests. */
+#include "stats.h"
+/* Includes the sbatch_t struct that leaf spheres are tested from. */
+#include "sbatch.h"
+
+/* Number of buckets used when estimating the surface area heuristic. */
+#define BVH_BUCKETS 16
+
+/* Largest number of objects that a leaf may be forced to hold. */
+#define BVH_MAX_LEAF 4
+
+/* Relative cost of visiting an inner node against testing one object. */
+#define BVH_TRAVERSE_COST 0.125
+
+/* Deepest a node may be built. Deeper ranges are left as large leaves. */
+#define BVH_MAX_DEPTH 64
+
+/* Depth of the traversal stack. One entry per level plus the root. */
+#define BVH_STACK_SIZE (BVH_MAX_DEPTH + 2)
+
+/* Relative padding applied to every box to absorb rounding in hits_*. It is
+ * scaled to the precision of real_t, so the boxes are padded in either
+ * build. */
+#define BVH_PAD (REAL_EPSILON * 64)
+
+/*
+ * A single node of the hierarchy. Nodes are stored depth first, so the left
+ * child of an inner node always directly follows it.
+ *
+ * Data Member: box    The box enclosing everything beneath this node.
+ * Data Member: offset For a leaf, the first index into prims. For an inner
+ *                     node, the index of the right child.
+ * Data Member: count  The number of objects in a leaf, or 0 for inner nodes.
+ * Data Member: axis   The axis an inner node was split on.
+ * Data Member: spheres  The number of spheres at the start of a leaf, which
+ *                       are tested together from the sphere batch.
+ */
+typedef struct bvh_node_type
+{
+    bbox_t box;
+    int offset;
+    int count;
+    int axis;
+    int spheres;
+} bvh_node_t;
+
+/*
+ * An infinite plane kept out of the hierarchy. Planes are tested on every
+ * query with plane_distance, which finds only the distance, and the hit
+ * record is filled in for the closest one alone.
+ *
+ * Data Member: plane  The plane data of the object.
+ * Data Member: obj    The plane, tiled plane or procedural plane object.
+ * Data Member: order  The id of the object, which follows the scene file.
+ */
+typedef struct bvh_plane_type
+{
+    struct plane_type* plane;
+    obj_t* obj;
+    int order;
+} bvh_plane_t;
+
+/*
+ * The bounding volume hierarchy over a scene store. Objects without a finite
+ * extent are kept apart and tested on every query, with infinite planes
+ * split out further so they can use a cheaper test.
+ *
+ * Data Member: nodes  The flattened tree of nodes.
+ * Data Member: num_nodes  The number of nodes in use.
+ * Data Member: prims  The bounded objects, ordered by leaf.
+ * Data Member: prim_order  The id of each prim, which follows the scene, used
+ *                          to break ties the same way as the scan.
+ * Data Member: num_prims  The number of bounded objects.
+ * Data Member: spheres  The centers and radii of the spheres among prims,
+ *                       in the same slots as in prims.
+ * Data Member: unbounded  The objects that could not be placed in the tree,
+ *                         other than the planes.
+ * Data Member: unbounded_order  The scene position of each unbounded object.
+ * Data Member: num_unbounded  The number of unbounded objects.
+ * Data Member: planes  The infinite planes.
+ * Data Member: num_planes  The number of infinite planes.
+ */
+typedef struct bvh_type
+{
+    bvh_node_t* nodes;
+    int num_nodes;
+    obj_t** prims;
+    int* prim_order;
+    int num_prims;
+    sbatch_t* spheres;
+    obj_t** unbounded;
+    int* unbounded_order;
+    int num_unbounded;
+    bvh_plane_t* planes;
+    int num_planes;
+} bvh_t;
+
+bvh_t* bvh_build(store_t* scene);
+
+int bvh_is_plane(obj_t* obj);
+
+int bvh_is_batched(obj_t* obj);
+
+obj_t* bvh_closest_object(bvh_t* bvh, real_t* base, real_t* dir,
+                          obj_t* last_hit, real_t* mindist, hit_t* hit);
+
+int ray_box(bbox_t* box, real_t* base, real_t* dir, real_t* tnear);
+
+obj_t* bvh_occluder(bvh_t* bvh, real_t* base, real_t* dir, obj_t* last_hit,
+                    real_t maxdist);
+
+void bvh_free(bvh_t* bvh);
@@ -16,27 +16,21 @@
  *
  * Return:  The new object that has been created.
  */
-obj_t* cone_init(FILE* in, int objtype)
+obj_t* cone_init(scene_in_t* in, int objtype)
 {
-    char buff[BUFF_SIZE];
     int pcount = 0;
     obj_t* obj = object_init(in, objtype);
     if (obj)
     {
         cone_t* cone = Malloc(sizeof(cone_t));
-        pcount += fscanf(in, "%lf %lf %lf",
-                         &cone->center[X], &cone->center[Y], &cone->center[Z]);
-        fgets(buff, BUFF_SIZE, in);
-        pcount += fscanf(in, "%lf %lf %lf",
-                         &cone->centerline[X], &cone->centerline[Y], 
-                         &cone->centerline[Z]);
-        fgets(buff, BUFF_SIZE, in);
-        pcount+= fscanf(in, "%lf %lf",
-                        &cone->radius, &cone->height);
-        fgets(buff, BUFF_SIZE, in);
+        pcount += scene_read(in, 3, &cone->center[X], &cone->center[Y],
+                             &cone->center[Z]);
+        pcount += scene_read(in, 3, &cone->centerline[X], &cone->centerline[Y],
+                             &cone->centerline[Z]);
+        pcount += scene_read(in, 2, &cone->radius, &cone->height);
         if (pcount == CONE_OBJS)
         {
-            double id_matrix[XYZ][XYZ];
+            real_t id_matrix[XYZ][XYZ];
             get_id_matrix(id_matrix);
             /* Adjustment for shapes aligned with the negative y axis. This
              * is a minor hack to adjust for this bad case. */
@@ -54,7 +48,11 @@ obj_t* cone_init(FILE* in, int objtype)
             unitvec3(cone->rotmat[Z], cone->rotmat[Z]);
             transpose_mat(cone->rotmat, cone->irot);
             cone->scale = pow(cone->radius, SQUARED) / cone->height;
-            obj->hits = cone_hits;
+            cone->aligned = (cone->centerline[X] == 0 &&
+                             cone->centerline[Y] != 0 &&
+                             cone->centerline[Z] == 0);
+            obj->hits = cone->aligned ? cone_hits_aligned : cone_hits;
+            obj->cold->surface = cone_surface;
             obj->priv = cone;
         }
         else
@@ -67,7 +65,8 @@ obj_t* cone_init(FILE* in, int objtype)
 }
 
 /*
- * Function for determining if a ray hit a cone.
+ * Function for determining if a ray hit a cone. The ray is rotated into the
+ * cone's own space, where its centerline is the y axis.
  *
  * Param: base  The starting point for the ray.
  * Param: dir   The direction of the approaching ray.
@@ -77,38 +76,54 @@ obj_t* cone_init(FILE* in, int objtype)
  *         If we miss, returns -1.
  */
 
-double cone_hits(double* base, double* dir_start, obj_t* obj)
+real_t cone_hits(real_t* base, real_t* dir_start, obj_t* obj)
 {
-    double t = MISS;
     cone_t* cone = (cone_t*)obj->priv;
-    double newbase[XYZ];
-    double newcenter[XYZ];
-    diff3(cone->center, base, newbase);
-    double dir[XYZ];
-    diff3(cone->center, cone->center, newcenter);
-    double idmat[XYZ][XYZ];
-    get_id_matrix(idmat);
-    if (!(cone->centerline[X] == idmat[Y][X] && cone->centerline[Y] != 0 &&
-        cone->centerline[Z] == idmat[Y][Z]))
-    {
-        transform(cone->rotmat, newbase, newbase);
-        transform(cone->rotmat, dir_start, dir);
-    }
-    else
-    {
-        transform(idmat, newbase, newbase);
-        transform(idmat, dir_start, dir);
-    }
-    double a = pow(dir[X], SQUARED) + pow(dir[Z], SQUARED) - cone->scale * 
-               pow(dir[Y], SQUARED);
-    double b = 2 * (newbase[X] * dir[X] + 
-                   (newbase[Z] * dir[Z] - cone->scale * dir[Y] * newbase[Y]));
-    double c = pow(newbase[X], SQUARED) + 
-               pow(newbase[Z], SQUARED) - cone->scale * 
-               pow(newbase[Y], SQUARED);
-    double discrim = pow(b, SQUARED) - 4 * a * c;
-    double t1 = ((-1 * b) - sqrt(discrim))/(2 * a);
-    double t2 = ((-1 * b) + sqrt(discrim))/(2 * a);
+    vec3_t newbase = vec3_sub(vec3_load(base), vec3_load(cone->center));
+    return cone_solve(obj, vec3_xform(cone->rotmat, newbase),
+                      vec3_xform(cone->rotmat, vec3_load(dir_start)));
+}
+
+/*
+ * Function for determining if a ray hit a cone whose centerline is already
+ * the y axis, so only the translation is needed.
+ *
+ * Param: base  The starting point for the ray.
+ * Param: dir   The direction of the approaching ray.
+ * Param: obj   The cone object that is being tested for hits.
+ *
+ * Return: The distance from our viewpoint that the object is at, if we hit.
+ *         If we miss, returns -1.
+ */
+real_t cone_hits_aligned(real_t* base, real_t* dir, obj_t* obj)
+{
+    cone_t* cone = (cone_t*)obj->priv;
+    return cone_solve(obj, vec3_sub(vec3_load(base), vec3_load(cone->center)),
+                      vec3_load(dir));
+}
+
+/*
+ * Solves for where a ray already in the cone's space meets it.
+ *
+ * Param: obj   The cone object being tested.
+ * Param: newbase  The start of the ray relative to the cone.
+ * Param: dir   The direction of the ray in the cone's space.
+ *
+ * Return: The distance to the closest hit, or MISS.
+ */
+real_t cone_solve(obj_t* obj, vec3_t newbase, vec3_t dir)
+{
+    real_t t = MISS;
+    cone_t* cone = (cone_t*)obj->priv;
+    real_t a = dir.x * dir.x + dir.z * dir.z - cone->scale *
+               (dir.y * dir.y);
+    real_t b = 2 * (newbase.x * dir.x + 
+                   (newbase.z * dir.z - cone->scale * dir.y * newbase.y));
+    real_t c = newbase.x * newbase.x + newbase.z * newbase.z -
+               cone->scale * (newbase.y * newbase.y);
+    real_t discrim = b * b - 4 * a * c;
+    real_t t1 = ((-1 * b) - sqrt(discrim))/(2 * a);
+    real_t t2 = ((-1 * b) + sqrt(discrim))/(2 * a);
     t2 = (check_cone_hit (obj, dir, newbase, t2));
     t1 = (check_cone_hit (obj, dir, newbase, t1));
     if (t1 == MISS)
@@ -128,49 +143,80 @@ double cone_hits(double* base, double* dir_start, obj_t* obj)
 
 /*
  * Function for checking both the positive and negative side of the quadratic
- * hit function.
+ * hit function. Only the height of the hit is needed to decide, so the rest
+ * of the hit is left to cone_surface.
  *
- * Param: obj  The object to check hits with and store a hitpoint in.
+ * Param: obj  The object to check hits with.
  * Param: dir  The direction of the current ray.
  * Param: newbase  The base of the ray we are shooting.
  * Param: t  The current distance from the object.
  *
- * Return:  The new distance for the object. 
+ * Return:  The new t value, representing the distance from the object.
  */
-double check_cone_hit(obj_t* obj, double* dir, double* newbase, double t)
+real_t check_cone_hit(obj_t* obj, vec3_t dir, vec3_t newbase, real_t t)
 {
     cone_t* cone = (cone_t*)(obj->priv);
-    double hit[XYZ];
-    double scaled_d[XYZ];
-    scale3(t, dir, scaled_d);
-    sum3(newbase, scaled_d, hit);
-    if (hit[Y] < 0 || hit[Y] > cone->height) 
+    real_t hit_y = newbase.y + t * dir.y;
+    if (hit_y < 0 || hit_y > cone->height)
     {
         t = MISS;
     }
-    else
+    return t;
+}
+
+/*
+ * Function for finding the hit location and normal on a cone. The ray is
+ * moved into the cone's space the same way the hits function moved it.
+ *
+ * Param: base  The starting point for the ray.
+ * Param: dir_start  The direction of the approaching ray.
+ * Param: t     The distance returned by the hits function.
+ * Param: obj   The cone object that was hit.
+ * Param: record  Output for the hit location and normal.
+ */
+void cone_surface(real_t* base, real_t* dir_start, real_t t, obj_t* obj,
+                  hit_t* record)
+{
+    cone_t* cone = (cone_t*)obj->priv;
+    vec3_t newbase = vec3_sub(vec3_load(base), vec3_load(cone->center));
+    vec3_t dir = vec3_load(dir_start);
+    if (!cone->aligned)
     {
-        double normal[XYZ];
-        double idmat[XYZ][XYZ];
-        get_id_matrix(idmat);
-        normal[X] = 2 * hit[X];
-        normal[Y] = -2 * cone->scale * hit[Y];
-        normal[Z] = 2 * hit[Z];
-        if (!(cone->centerline[X] == idmat[Y][X] && 
-              cone->centerline[Y] != 0 &&
-              cone->centerline[Z] == idmat[Y][Z]))
-        {
-            transform(cone->irot, hit, obj->hitloc);
-            transform(cone->irot, normal, obj->normal);
-        }
-        else
-        {
-            transform(idmat, hit, obj->hitloc);
-            transform(idmat, normal, obj->normal);
-        }
-        sum3(obj->hitloc, cone->center, obj->hitloc);
+        newbase = vec3_xform(cone->rotmat, newbase);
+        dir = vec3_xform(cone->rotmat, dir);
     }
-    return t;
+    vec3_t hit = vec3_along(newbase, dir, t);
+    vec3_t normal = vec3(2 * hit.x, -2 * cone->scale * hit.y, 2 * hit.z);
+    if (!cone->aligned)
+    {
+        hit = vec3_xform(cone->irot, hit);
+        normal = vec3_xform(cone->irot, normal);
+    }
+    vec3_store(vec3_add(hit, vec3_load(cone->center)), record->hitloc);
+    vec3_store(normal, record->normal);
+}
+
+/*
+ * Function for finding the world space bounds of a cone. The radius grows
+ * linearly from the tip at the center, so the box of the tip and the top cap
+ * holds the whole cone. The top cap has radius^2 = scale * height^2.
+ *
+ * Param: obj  The cone object to bound.
+ * Param: box  The output box.
+ *
+ * Return: BOUNDED.
+ */
+int cone_bounds(obj_t* obj, bbox_t* box)
+{
+    cone_t* cone = (cone_t*)obj->priv;
+    real_t top[XYZ];
+    scale3(cone->height, cone->rotmat[Y], top);
+    sum3(cone->center, top, top);
+    box_empty(box);
+    box_add_point(box, cone->center);
+    box_add_disc(box, top, cone->rotmat[Y],
+                 sqrt(fabs(cone->scale)) * fabs(cone->height));
+    return BOUNDED;
 }
 
 /*
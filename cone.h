@@ -14,6 +14,8 @@
 #include "utils.h"
 /* Included for matrix functions. */
 #include "matlib.h"
+/* Included for the bbox_t struct. */
+#include "bbox.h"
 
 /* The number of dimensions in our world. */
 #define XYZ 3
@@ -22,7 +24,7 @@
 #define CONE_OBJS 8 
 
 /* Power of 2. */
-#define SQUARED 2
+#define SQUARED 2.0
 
 /*
  * This type contains the information necessary to simulate
@@ -37,23 +39,35 @@
  * Data Member: rotmat  The rotation matrix necessary for rotating this object
  *              to make hit detection easier.
  * Data Member: irot  The transpose of rotmat, for reversing the transformation.
+ * Data Member: aligned  Nonzero when the centerline already points along +y,
+ *                       so rays need no rotation into the cone's space.
  */
 typedef struct cone_type
 {
-    double center[XYZ];
-    double centerline[XYZ];
-    double radius;
-    double height;
-    double scale; /* r^2 / h */
-    double rotmat[XYZ][XYZ];
-    double irot[XYZ][XYZ];
+    real_t center[XYZ];
+    real_t centerline[XYZ];
+    real_t radius;
+    real_t height;
+    real_t scale; /* r^2 / h */
+    real_t rotmat[XYZ][XYZ];
+    real_t irot[XYZ][XYZ];
+    int aligned;
 } cone_t;
 
-obj_t* cone_init(FILE* in, int objtype);
+obj_t* cone_init(scene_in_t* in, int objtype);
 
-double cone_hits(double* base, double* dir_start, obj_t* obj);
+real_t cone_hits(real_t* base, real_t* dir_start, obj_t* obj);
 
-double check_cone_hit(obj_t* obj, double* dir, double* newbase, double t);
+real_t cone_hits_aligned(real_t* base, real_t* dir, obj_t* obj);
+
+real_t cone_solve(obj_t* obj, vec3_t newbase, vec3_t dir);
+
+int cone_bounds(obj_t* obj, bbox_t* box);
+
+real_t check_cone_hit(obj_t* obj, vec3_t dir, vec3_t newbase, real_t t);
+
+void cone_surface(real_t* base, real_t* dir, real_t t, obj_t* obj,
+                  hit_t* record);
 
 void dump_cone(FILE* out, obj_t* obj);
 
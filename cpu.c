@@ -0,0 +1,132 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This file contains the processor feature checks used to pick which
+ * variant of the vector kernels to run. The checks read cpuid, and for the
+ * AVX sets also ask the operating system, through xgetbv, whether it saves
+ * the wider registers across context switches.
+ */
+
+/* Header file for this source file. */
+#include "cpu.h"
+
+/* Included for strcmp, used to look up instruction set names. */
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+/* Included for __get_cpuid and __get_cpuid_count. */
+#include <cpuid.h>
+
+/* Feature bits of cpuid leaf 1. */
+#define CPUID_SSE2_EDX     (1u << 26)
+#define CPUID_OSXSAVE_ECX  (1u << 27)
+
+/* Feature bits of cpuid leaf 7. */
+#define CPUID_AVX2_EBX     (1u << 5)
+#define CPUID_AVX512F_EBX  (1u << 16)
+
+/* The register states the operating system must save, read from XCR0. */
+#define XCR0_AVX     0x06u
+#define XCR0_AVX512  0xe6u
+#endif
+
+/* The names accepted by cpu_parse_isa, indexed by instruction set. */
+static char* isa_names[ISA_COUNT] = {"scalar", "sse2", "avx2", "avx512"};
+
+#if defined(__x86_64__) || defined(__i386__)
+/*
+ * Reads the extended control register that says which register states the
+ * operating system saves.
+ * Return: The low half of XCR0.
+ */
+static unsigned int cpu_xcr0(void)
+{
+    unsigned int eax, edx;
+    __asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return eax;
+}
+#endif
+
+/*
+ * Decides if the running processor and operating system can execute the
+ * kernels built for an instruction set.
+ *
+ * Param: isa  The instruction set to check.
+ * Return: TRUE if it is supported.
+ */
+int cpu_supports(int isa)
+{
+    if (isa == ISA_SCALAR)
+    {
+        return 1;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        return 0;
+    }
+    if (isa == ISA_SSE2)
+    {
+        return (edx & CPUID_SSE2_EDX) != 0;
+    }
+    if (!(ecx & CPUID_OSXSAVE_ECX) ||
+        !__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    {
+        return 0;
+    }
+    if (isa == ISA_AVX2)
+    {
+        return (ebx & CPUID_AVX2_EBX) &&
+               (cpu_xcr0() & XCR0_AVX) == XCR0_AVX;
+    }
+    if (isa == ISA_AVX512)
+    {
+        return (ebx & CPUID_AVX512F_EBX) &&
+               (cpu_xcr0() & XCR0_AVX512) == XCR0_AVX512;
+    }
+#endif
+    return 0;
+}
+
+/*
+ * Finds the most able instruction set the running processor supports.
+ * Return: The instruction set.
+ */
+int cpu_best_isa(void)
+{
+    int isa = ISA_COUNT - 1;
+    while (isa > ISA_SCALAR && !cpu_supports(isa))
+    {
+        isa--;
+    }
+    return isa;
+}
+
+/*
+ * Looks up an instruction set by name.
+ * Param: name  The name, as printed by cpu_isa_name.
+ * Return: The instruction set, or ISA_UNKNOWN.
+ */
+int cpu_parse_isa(char* name)
+{
+    for (int i = 0; i < ISA_COUNT; i++)
+    {
+        if (!strcmp(name, isa_names[i]))
+        {
+            return i;
+        }
+    }
+    return ISA_UNKNOWN;
+}
+
+/*
+ * Names an instruction set.
+ * Param: isa  The instruction set.
+ * Return: Its name.
+ */
+char* cpu_isa_name(int isa)
+{
+    return isa_names[isa];
+}
@@ -0,0 +1,31 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This is the header file for the cpu.c source file. It names the vector
+ * instruction sets that kernels are compiled for, and finds out at startup
+ * which of them the processor running the tracer supports.
+ */
+
+/* Ensures this header file is only included once. */
+#pragma once
+
+/* The instruction sets kernels may be built for, from least to most able. */
+#define ISA_SCALAR  0
+#define ISA_SSE2    1
+#define ISA_AVX2    2
+#define ISA_AVX512  3
+
+/* The number of instruction sets above. */
+#define ISA_COUNT   4
+
+/* Returned by cpu_parse_isa for a name it does not know. */
+#define ISA_UNKNOWN -1
+
+int cpu_supports(int isa);
+
+int cpu_best_isa(void);
+
+int cpu_parse_isa(char* name);
+
+char* cpu_isa_name(int isa);
@@ -15,26 +15,21 @@
  * Param: objtype  The object type of the object we are creating.
  * Return:  The new object that has been created.
  */
-obj_t* cyl_init(FILE* in, int objtype)
+obj_t* cyl_init(scene_in_t* in, int objtype)
 {
-    char buff[BUFF_SIZE];
     int pcount = 0;
     obj_t* obj = object_init(in, objtype);
     if (obj)
     {
         cyl_t* cyl = Malloc(sizeof(cyl_t));
-        pcount += fscanf(in, "%lf %lf %lf",
-                         &cyl->center[X], &cyl->center[Y], &cyl->center[Z]);
-        fgets(buff, BUFF_SIZE, in);
-        pcount += fscanf(in, "%lf %lf %lf",
-                         &cyl->centerline[X], &cyl->centerline[Y], 
-                         &cyl->centerline[Z]);
-        fgets(buff, BUFF_SIZE, in);
-        pcount += fscanf(in, "%lf %lf", &cyl->radius, &cyl->height);
-        fgets(buff, BUFF_SIZE, in);
+        pcount += scene_read(in, 3, &cyl->center[X], &cyl->center[Y],
+                             &cyl->center[Z]);
+        pcount += scene_read(in, 3, &cyl->centerline[X], &cyl->centerline[Y],
+                             &cyl->centerline[Z]);
+        pcount += scene_read(in, 2, &cyl->radius, &cyl->height);
         if (pcount == CYL_OBJS)
         {
-            double id_matrix[XYZ][XYZ];
+            real_t id_matrix[XYZ][XYZ];
             get_id_matrix(id_matrix);
             /* Adjustment for shapes aligned with the negative y axis. This
              * is a minor hack to adjust for this bad case. */
@@ -50,7 +45,12 @@ obj_t* cyl_init(FILE* in, int objtype)
             cross_prod(cyl->rotmat[X], cyl->rotmat[Y], cyl->rotmat[Z]);
             unitvec3(cyl->rotmat[Z], cyl->rotmat[Z]);
             transpose_mat(cyl->rotmat, cyl->irot);
-            obj->hits = cyl_hits;
+            cyl->radius_sq = cyl->radius * cyl->radius;
+            cyl->aligned = (cyl->centerline[X] == 0 &&
+                            cyl->centerline[Y] != 0 &&
+                            cyl->centerline[Z] == 0);
+            obj->hits = cyl->aligned ? cyl_hits_aligned : cyl_hits;
+            obj->cold->surface = cyl_surface;
             obj->priv = cyl;
         }
         else
@@ -63,7 +63,8 @@ obj_t* cyl_init(FILE* in, int objtype)
 }
 
 /*
- * Function for determining if a ray hit a cylinder.
+ * Function for determining if a ray hit a cylinder. The ray is rotated into
+ * the cylinder's own space, where its centerline is the y axis.
  *
  * Param: base  The starting point for the ray.
  * Param: dir   The direction of the approaching ray.
@@ -72,36 +73,52 @@ obj_t* cyl_init(FILE* in, int objtype)
  * Return: The distance from our viewpoint that the object is at, if we hit.
  *         If we miss, returns -1.
  */
-double cyl_hits(double* base, double* dir_start, obj_t* obj)
+real_t cyl_hits(real_t* base, real_t* dir_start, obj_t* obj)
 {
-    double t = MISS;
     cyl_t* cyl = (cyl_t*)obj->priv;
-    double newbase[XYZ];
-    double newcenter[XYZ];
-    double dir[XYZ];
-    diff3(cyl->center, base, newbase);
-    diff3(cyl->center, cyl->center, newcenter);
-    double idmat[XYZ][XYZ];
-    get_id_matrix(idmat);
-    if (!(cyl->centerline[X] == idmat[Y][X] && 
-          cyl->centerline[Y] != 0 &&  
-          cyl->centerline[Z] == idmat[Y][Z]))
-    {
-        transform(cyl->rotmat, newbase, newbase);
-        transform(cyl->rotmat, dir_start, dir);
-    }
-    else
-    {
-        transform(idmat, newbase, newbase);
-        transform(idmat, dir_start, dir);
-    }
-    double a = pow(dir[X], SQUARED) + pow(dir[Z], SQUARED);
-    double b = 2 * (newbase[X] * dir[X] + newbase[Z] * dir[Z]);
-    double c = pow(newbase[X], SQUARED) + pow(newbase[Z], SQUARED) - 
-               pow(cyl->radius, SQUARED);
-    double discrim = (pow(b, SQUARED) - 4 * a * c);
-    double t1 = ((-1 * b) - sqrt(discrim))/(2 * a);
-    double t2 = ((-1 * b) + sqrt(discrim))/(2 * a);
+    vec3_t newbase = vec3_sub(vec3_load(base), vec3_load(cyl->center));
+    return cyl_solve(obj, vec3_xform(cyl->rotmat, newbase),
+                     vec3_xform(cyl->rotmat, vec3_load(dir_start)));
+}
+
+/*
+ * Function for determining if a ray hit a cylinder whose centerline is
+ * already the y axis, so only the translation is needed.
+ *
+ * Param: base  The starting point for the ray.
+ * Param: dir   The direction of the approaching ray.
+ * Param: obj   The cylinder object that is being tested for hits.
+ *
+ * Return: The distance from our viewpoint that the object is at, if we hit.
+ *         If we miss, returns -1.
+ */
+real_t cyl_hits_aligned(real_t* base, real_t* dir, obj_t* obj)
+{
+    cyl_t* cyl = (cyl_t*)obj->priv;
+    return cyl_solve(obj, vec3_sub(vec3_load(base), vec3_load(cyl->center)),
+                     vec3_load(dir));
+}
+
+/*
+ * Solves for where a ray already in the cylinder's space meets it.
+ *
+ * Param: obj   The cylinder object being tested.
+ * Param: newbase  The start of the ray relative to the cylinder.
+ * Param: dir   The direction of the ray in the cylinder's space.
+ *
+ * Return: The distance to the closest hit, or MISS.
+ */
+real_t cyl_solve(obj_t* obj, vec3_t newbase, vec3_t dir)
+{
+    real_t t = MISS;
+    cyl_t* cyl = (cyl_t*)obj->priv;
+    real_t a = dir.x * dir.x + dir.z * dir.z;
+    real_t b = 2 * (newbase.x * dir.x + newbase.z * dir.z);
+    real_t c = newbase.x * newbase.x + newbase.z * newbase.z -
+               cyl->radius_sq;
+    real_t discrim = (b * b - 4 * a * c);
+    real_t t1 = ((-1 * b) - sqrt(discrim))/(2 * a);
+    real_t t2 = ((-1 * b) + sqrt(discrim))/(2 * a);
     t2 = (check_cyl_hit (obj, dir, newbase, t2));
     t1 = (check_cyl_hit (obj, dir, newbase, t1));
     if (t1 == MISS)
@@ -121,49 +138,78 @@ double cyl_hits(double* base, double* dir_start, obj_t* obj)
 
 /*
  * Function for checking both the positive and negative side of the quadratic
- * hit function.
+ * hit function. Only the height of the hit is needed to decide, so the rest
+ * of the hit is left to cyl_surface.
  *
- * Param: obj  The object to check hits with and store a hitpoint in.
+ * Param: obj  The object to check hits with.
  * Param: dir  The direction of the current ray.
  * Param: newbase  The base of the ray we are shooting.
  * Param: t  The current distance from the object.
  *
- * return:  The new t value, representing the distance from the object.
+ * Return:  The new t value, representing the distance from the object.
  */
-double check_cyl_hit(obj_t* obj, double* dir, double* newbase, double t)
+real_t check_cyl_hit(obj_t* obj, vec3_t dir, vec3_t newbase, real_t t)
 {
     cyl_t* cyl = (cyl_t*)(obj->priv);
-    double hit[XYZ];
-    double scaled_d[XYZ];
-    scale3(t, dir, scaled_d);
-    sum3(newbase, scaled_d, hit);
-    if (hit[Y] < 0 || hit[Y] > cyl->height) 
+    real_t hit_y = newbase.y + t * dir.y;
+    if (hit_y < 0 || hit_y > cyl->height)
     {
         t = MISS;
     }
-    else
+    return t;
+}
+
+/*
+ * Function for finding the hit location and normal on a cylinder. The ray is
+ * moved into the cylinder's space the same way the hits function moved it.
+ *
+ * Param: base  The starting point for the ray.
+ * Param: dir_start  The direction of the approaching ray.
+ * Param: t     The distance returned by the hits function.
+ * Param: obj   The cylinder object that was hit.
+ * Param: record  Output for the hit location and normal.
+ */
+void cyl_surface(real_t* base, real_t* dir_start, real_t t, obj_t* obj,
+                 hit_t* record)
+{
+    cyl_t* cyl = (cyl_t*)obj->priv;
+    vec3_t newbase = vec3_sub(vec3_load(base), vec3_load(cyl->center));
+    vec3_t dir = vec3_load(dir_start);
+    if (!cyl->aligned)
     {
-        double normal[XYZ];
-        double idmat[XYZ][XYZ];
-        get_id_matrix(idmat);
-        copy3(hit, normal);
-        normal[Y] = 0;
-        unitvec3(normal, normal);
-        if (!(cyl->centerline[X] == idmat[Y][X] && 
-              cyl->centerline[Y] != 0 &&
-              cyl->centerline[Z] == idmat[Y][Z]))
-        {
-            transform(cyl->irot, hit, obj->hitloc);
-            transform(cyl->irot, normal, obj->normal);
-        }
-        else
-        {
-            transform(idmat, hit, obj->hitloc);
-            transform(idmat, normal, obj->normal);
-        }
-        sum3(obj->hitloc, cyl->center, obj->hitloc);
+        newbase = vec3_xform(cyl->rotmat, newbase);
+        dir = vec3_xform(cyl->rotmat, dir);
     }
-    return t;
+    vec3_t hit = vec3_along(newbase, dir, t);
+    vec3_t normal = vec3_unit(vec3(hit.x, 0, hit.z));
+    if (!cyl->aligned)
+    {
+        hit = vec3_xform(cyl->irot, hit);
+        normal = vec3_xform(cyl->irot, normal);
+    }
+    vec3_store(vec3_add(hit, vec3_load(cyl->center)), record->hitloc);
+    vec3_store(normal, record->normal);
+}
+
+/*
+ * Function for finding the world space bounds of a cylinder. The sides are
+ * straight, so the box of the two end caps holds the whole cylinder.
+ *
+ * Param: obj  The cylinder object to bound.
+ * Param: box  The output box.
+ *
+ * Return: BOUNDED.
+ */
+int cyl_bounds(obj_t* obj, bbox_t* box)
+{
+    cyl_t* cyl = (cyl_t*)obj->priv;
+    real_t top[XYZ];
+    scale3(cyl->height, cyl->rotmat[Y], top);
+    sum3(cyl->center, top, top);
+    box_empty(box);
+    box_add_disc(box, cyl->center, cyl->rotmat[Y], fabs(cyl->radius));
+    box_add_disc(box, top, cyl->rotmat[Y], fabs(cyl->radius));
+    return BOUNDED;
 }
 
 /*
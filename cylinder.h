@@ -17,6 +17,9 @@
 /* Includes the matrix math library file that we have created. */
 #include "matlib.h"
 
+/* Includes the bbox_t struct for reporting bounds. */
+#include "bbox.h"
+
 /* The number of dimensions that we are modeling in. */
 #define XYZ 3
 
@@ -34,23 +37,37 @@
  * Data Member: rotmat  The rotation matrix necessary for rotating this object
  *              to make hit detection easier.
  * Data Member: irot  The transpose of rotmat, for reversing the transformation.
+ * Data Member: radius_sq  The radius squared, used on every hit test.
+ * Data Member: aligned  Nonzero when the centerline already points along +y,
+ *                       so rays need no rotation into the cylinder's space.
  */
 typedef struct cyl_type
 {
-    double center[XYZ];
-    double centerline[XYZ];
-    double radius;
-    double height;
-    double rotmat[XYZ][XYZ];
-    double irot[XYZ][XYZ];
+    real_t center[XYZ];
+    real_t centerline[XYZ];
+    real_t radius;
+    real_t height;
+    real_t rotmat[XYZ][XYZ];
+    real_t irot[XYZ][XYZ];
+    real_t radius_sq;
+    int aligned;
 } cyl_t;
 
-obj_t* cyl_init(FILE* in, int objtype);
+obj_t* cyl_init(scene_in_t* in, int objtype);
+
+real_t cyl_hits(real_t* base, real_t* dir, obj_t* obj);
+
+real_t cyl_hits_aligned(real_t* base, real_t* dir, obj_t* obj);
 
-double cyl_hits(double* base, double* dir, obj_t* obj);
+real_t cyl_solve(obj_t* obj, vec3_t newbase, vec3_t dir);
+
+int cyl_bounds(obj_t* obj, bbox_t* box);
 
 void dump_cyl(FILE* out, obj_t* obj);
 
 void kill_cyl(void* cylinder);
 
-double check_cyl_hit(obj_t* obj, double* dir, double* newbase, double t);
+real_t check_cyl_hit(obj_t* obj, vec3_t dir, vec3_t newbase, real_t t);
+
+void cyl_surface(real_t* base, real_t* dir, real_t t, obj_t* obj,
+                 hit_t* record);
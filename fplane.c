@@ -9,9 +9,8 @@
 /* The header for this source file. */
 #include "fplane.h"
 
-obj_t* fplane_init(FILE* in, int objtype)
+obj_t* fplane_init(scene_in_t* in, int objtype)
 {
-    char buff[BUFF_SIZE];
     obj_t* obj = plane_init(in, objtype); 
     if(obj)
     {
@@ -19,18 +18,14 @@ obj_t* fplane_init(FILE* in, int objtype)
         plane_t* plane = (plane_t*)obj->priv;
         fplane_t* fplane = Malloc(sizeof(fplane_t));
         plane->priv = fplane;
-        pcount += fscanf(in, "%lf %lf %lf",
-                         &(fplane->xdir[X]),
-                         &(fplane->xdir[Y]),
-                         &(fplane->xdir[Z]));
-        fgets(buff, BUFF_SIZE, in);
-        pcount += fscanf(in, "%lf %lf", &(fplane->size[X]),&(fplane->size[Y]));
-        fgets(buff, BUFF_SIZE, in);
+        pcount += scene_read(in, 3, &(fplane->xdir[X]), &(fplane->xdir[Y]),
+                             &(fplane->xdir[Z]));
+        pcount += scene_read(in, 2, &(fplane->size[X]), &(fplane->size[Y]));
         if (pcount == FPLANE_OBJS)
         {
-            double unit_norm[XYZ];
+            real_t unit_norm[XYZ];
             unitvec3(plane->normal, unit_norm);
-            double unit_xdir[XYZ];
+            real_t unit_xdir[XYZ];
             unitvec3(fplane->xdir, unit_xdir);
             projection(unit_xdir, unit_norm, unit_xdir);
             unitvec3(unit_xdir, unit_xdir);
@@ -59,18 +54,20 @@ obj_t* fplane_init(FILE* in, int objtype)
  *
  * Return: The distance to the object.
  */
-double hits_fplane(double* base, double* dir, obj_t* obj)
+real_t hits_fplane(real_t* base, real_t* dir, obj_t* obj)
 {
-    double t = hits_plane(base, dir, obj);
+    plane_t* plane = (plane_t*)obj->priv;
+    vec3_t start = vec3_load(base);
+    vec3_t d = vec3_unit(vec3_load(dir));
+    real_t t = plane_distance(plane, start, d);
     if (t != MISS)
     {
-        plane_t* plane = (plane_t*)obj->priv;
         fplane_t* fplane = (fplane_t*)plane->priv;
-        double newhit[XYZ];
-        diff3(plane->point, obj->hitloc, newhit);
-        transform(fplane->rotmat, newhit, newhit);
-        if (newhit[X] > fplane->size[X] || newhit[X] < 0.0 ||
-             newhit[Y] > fplane->size[Y] || newhit[Y] < 0.0)
+        vec3_t hitloc = vec3_along(start, d, t);
+        vec3_t newhit = vec3_xform(fplane->rotmat,
+                                   vec3_sub(hitloc, vec3_load(plane->point)));
+        if (newhit.x > fplane->size[X] || newhit.x < 0.0 ||
+             newhit.y > fplane->size[Y] || newhit.y < 0.0)
         {
             t = MISS;
         }
@@ -78,6 +75,34 @@ double hits_fplane(double* base, double* dir, obj_t* obj)
     return t;
 }
 
+/*
+ * Function for finding the world space bounds of a finite plane, from the
+ * four corners of the rectangle it spans along its rotated x and y axes.
+ *
+ * Param: obj  The finite plane object to bound.
+ * Param: box  The output box.
+ *
+ * Return: BOUNDED.
+ */
+int fplane_bounds(obj_t* obj, bbox_t* box)
+{
+    plane_t* plane = (plane_t*)obj->priv;
+    fplane_t* fplane = (fplane_t*)plane->priv;
+    real_t corner[XYZ];
+    real_t step[XYZ];
+    box_empty(box);
+    box_add_point(box, plane->point);
+    scale3(fplane->size[X], fplane->rotmat[X], step);
+    sum3(plane->point, step, corner);
+    box_add_point(box, corner);
+    scale3(fplane->size[Y], fplane->rotmat[Y], step);
+    sum3(corner, step, corner);
+    box_add_point(box, corner);
+    sum3(plane->point, step, corner);
+    box_add_point(box, corner);
+    return BOUNDED;
+}
+
 /*
  * Function for dumping a finite plane object.
  * Param: out  The stream to dump to.
@@ -31,16 +31,18 @@
  */
 typedef struct fplane_type
 {
-    double xdir[XYZ];
-    double size[XY];
-    double rotmat[XYZ][XYZ];
-    double lasthit[XY];
+    real_t xdir[XYZ];
+    real_t size[XY];
+    real_t rotmat[XYZ][XYZ];
+    real_t lasthit[XY];
     void* priv;
 } fplane_t;
 
-obj_t* fplane_init(FILE* in, int objtype);
+obj_t* fplane_init(scene_in_t* in, int objtype);
 
-double hits_fplane(double* base, double* dir, obj_t* obj);
+real_t hits_fplane(real_t* base, real_t* dir, obj_t* obj);
+
+int fplane_bounds(obj_t* obj, bbox_t* box);
 
 void dump_fplane(FILE* out, obj_t* obj);
 
@@ -0,0 +1,329 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * A microbenchmark for the hit tests. Each quadric is built once with its
+ * centerline along the y axis and once tilted, and the same fixed set of
+ * rays is fired at it many times. A field of spheres is then tested one at
+ * a time through hits_sphere and as a batch through sbatch_nearest, once
+ * with each instruction set this processor supports. The time per test is
+ * printed as CSV, so the kernels can be compared.
+ *
+ * Usage: hitbench [passes]
+ */
+
+/* Includes the shape init functions and the store used to free them. */
+#include "model.h"
+
+/* Includes hit_epsilon, the nearest distance a hit counts at. */
+#include "raytrace.h"
+
+/* Includes stats_clock for timing the passes. */
+#include "stats.h"
+
+/* Includes rng_t for drawing repeatable rays. */
+#include "rng.h"
+
+/* Includes the sphere batch being measured. */
+#include "sbatch.h"
+
+/* The number of distinct rays fired at each shape in a pass. */
+#define HB_RAYS 4096
+
+/* The number of times the rays are fired when no count is given. */
+#define HB_PASSES 100
+
+/* The number of spheres in the field, and the radius of each. */
+#define HB_SPHERES 64
+#define HB_RADIUS 0.3
+
+/* The number of arguments this tool takes at most, including its name. */
+#define HB_ARGS 2
+
+/* Half the width of the square the rays are aimed into. */
+#define HB_SPREAD 3.0
+
+/* The seed the rays are drawn from. */
+#define HB_SEED 1
+
+/* The material every shape is given, which the hit tests never read. */
+#define HB_MATERIAL "1 1 1\n1 1 1\n0 0 0\n"
+
+/*
+ * One shape to time.
+ *
+ * Data Member: name  The name printed for the shape.
+ * Data Member: variant  The name printed for the kind of kernel tested.
+ * Data Member: init  The function that reads the shape.
+ * Data Member: objtype  The object type the shape is read as.
+ * Data Member: shape  The lines describing the shape, after its material.
+ */
+typedef struct hb_case_type
+{
+    char* name;
+    char* variant;
+    obj_t* (*init)(scene_in_t* in, int objtype);
+    int objtype;
+    char* shape;
+} hb_case_t;
+
+/* The lines that follow a shape's centerline, for each kind of quadric. */
+#define HB_CYL "1 2\n"
+#define HB_PARAB "1 2\n"
+#define HB_CONE "1 2\n"
+#define HB_HYPERB "1 1\n0.5\n"
+
+/* The two centerlines every shape is timed with. */
+#define HB_ALIGNED "0 1 0\n"
+#define HB_TILTED "0.3 1 0.2\n"
+
+/* The center every shape is placed at. */
+#define HB_CENTER "0 -1 -5\n"
+
+static hb_case_t hb_cases[] =
+{
+    {"cylinder", "aligned", cyl_init, CYLINDER, HB_CENTER HB_ALIGNED HB_CYL},
+    {"cylinder", "tilted", cyl_init, CYLINDER, HB_CENTER HB_TILTED HB_CYL},
+    {"cone", "aligned", cone_init, CONE, HB_CENTER HB_ALIGNED HB_CONE},
+    {"cone", "tilted", cone_init, CONE, HB_CENTER HB_TILTED HB_CONE},
+    {"paraboloid", "aligned", parab_init, PARABOLOID,
+     HB_CENTER HB_ALIGNED HB_PARAB},
+    {"paraboloid", "tilted", parab_init, PARABOLOID,
+     HB_CENTER HB_TILTED HB_PARAB},
+    {"hyperboloid", "aligned", hyperb_init, HYPERBOLOID,
+     HB_CENTER HB_ALIGNED HB_HYPERB},
+    {"hyperboloid", "tilted", hyperb_init, HYPERBOLOID,
+     HB_CENTER HB_TILTED HB_HYPERB}
+};
+
+/*
+ * Builds a shape from its description.
+ *
+ * Param: text  The description, starting with the material.
+ * Param: init  The function that reads the shape.
+ * Param: objtype  The object type the shape is read as.
+ *
+ * Return: The new object, or NULL if it could not be read.
+ */
+obj_t* hb_build(char* text, obj_t* (*init)(scene_in_t* in, int objtype),
+                int objtype)
+{
+    FILE* in = fmemopen(text, strlen(text), "r");
+    if (!in)
+    {
+        return NULL;
+    }
+    scene_in_t* scene = scene_open(in, FALSE);
+    obj_t* obj = init(scene, objtype);
+    scene_close(scene);
+    fclose(in);
+    return obj;
+}
+
+/*
+ * Fires every ray at a shape a number of times.
+ *
+ * Param: obj  The shape to test.
+ * Param: base  The start of every ray.
+ * Param: dirs  The unit directions of the rays.
+ * Param: passes  The number of times to fire the rays.
+ * Param: hits  Output for the number of rays in one pass that hit.
+ *
+ * Return: The time taken in seconds.
+ */
+double hb_time(obj_t* obj, real_t* base, real_t dirs[][XYZ], int passes,
+               int* hits)
+{
+    double start = stats_clock();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        *hits = 0;
+        for (int i = 0; i < HB_RAYS; i++)
+        {
+            if (obj->hits(base, dirs[i], obj) != MISS)
+            {
+                (*hits)++;
+            }
+        }
+    }
+    return stats_clock() - start;
+}
+
+/*
+ * Finds the nearest of a list of spheres one at a time, as the scan does.
+ *
+ * Param: spheres  The spheres to test.
+ * Param: base  The start of every ray.
+ * Param: dirs  The unit directions of the rays.
+ * Param: passes  The number of times to fire the rays.
+ * Param: hits  Output for the number of sphere tests in one pass that hit.
+ *
+ * Return: The time taken in seconds.
+ */
+double hb_time_scalar(obj_t** spheres, real_t* base, real_t dirs[][XYZ],
+                      int passes, int* hits)
+{
+    real_t min_dist = hit_epsilon(base);
+    double start = stats_clock();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        *hits = 0;
+        for (int i = 0; i < HB_RAYS; i++)
+        {
+            real_t mindist = MISS;
+            for (int j = 0; j < HB_SPHERES; j++)
+            {
+                real_t dist = spheres[j]->hits(base, dirs[i], spheres[j]);
+                if (dist >= min_dist)
+                {
+                    (*hits)++;
+                    mindist = mindist == MISS || dist < mindist ? dist
+                                                                : mindist;
+                }
+            }
+        }
+    }
+    return stats_clock() - start;
+}
+
+/*
+ * Finds the nearest of the same spheres through the batch kernel.
+ *
+ * Param: batch  The spheres to test.
+ * Param: base  The start of every ray.
+ * Param: dirs  The unit directions of the rays.
+ * Param: passes  The number of times to fire the rays.
+ * Param: hits  Output for the number of sphere tests in one pass that hit.
+ *
+ * Return: The time taken in seconds.
+ */
+double hb_time_batch(sbatch_t* batch, real_t* base, real_t dirs[][XYZ],
+                     int passes, int* hits)
+{
+    real_t min_dist = hit_epsilon(base);
+    double start = stats_clock();
+    for (int pass = 0; pass < passes; pass++)
+    {
+        *hits = 0;
+        for (int i = 0; i < HB_RAYS; i++)
+        {
+            real_t dist;
+            int ray_hits;
+            sbatch_nearest(batch, 0, HB_SPHERES, base, dirs[i], -1, min_dist,
+                           &dist, &ray_hits);
+            *hits += ray_hits;
+        }
+    }
+    return stats_clock() - start;
+}
+
+/*
+ * Prints one line of the report.
+ *
+ * Param: name  The shape tested.
+ * Param: variant  The kind of kernel tested.
+ * Param: seconds  The time taken.
+ * Param: tests  The number of tests made in that time.
+ * Param: hit_rate  The fraction of tests that hit.
+ */
+void hb_report(char* name, char* variant, double seconds, double tests,
+               double hit_rate)
+{
+    printf("%s,%s,%.1f,%.3f\n", name, variant, seconds * 1e9 / tests,
+           hit_rate);
+}
+
+/*
+ * Times every shape and prints one CSV line for each.
+ */
+int main(int argc, char** argv)
+{
+    int passes = HB_PASSES;
+    if (argc > HB_ARGS || (argc == HB_ARGS && (passes = atoi(argv[1])) <= 0))
+    {
+        fprintf(stderr, "Usage: %s [passes]\n", argv[0]);
+        exit(1);
+    }
+    /* Aims the rays from the viewpoint into a square around the shapes. */
+    real_t base[XYZ] = {0, 0, 5};
+    real_t (*dirs)[XYZ] = Malloc(sizeof(real_t[XYZ]) * HB_RAYS);
+    rng_t rng;
+    rng_seed(&rng, HB_SEED, 0, 0, 0);
+    for (int i = 0; i < HB_RAYS; i++)
+    {
+        real_t target[XYZ] =
+        {
+            (real_t)((2 * rng_uniform(&rng) - 1) * HB_SPREAD),
+            (real_t)((2 * rng_uniform(&rng) - 1) * HB_SPREAD),
+            -5
+        };
+        diff3(base, target, dirs[i]);
+        unitvec3(dirs[i], dirs[i]);
+    }
+    printf("shape,variant,ns_per_test,hit_rate\n");
+    store_t* store = store_init();
+    int hits;
+    int num_cases = (int)(sizeof(hb_cases) / sizeof(hb_cases[0]));
+    for (int i = 0; i < num_cases; i++)
+    {
+        char text[BUFF_SIZE];
+        snprintf(text, BUFF_SIZE, "%s%s", HB_MATERIAL, hb_cases[i].shape);
+        obj_t* obj = hb_build(text, hb_cases[i].init, hb_cases[i].objtype);
+        if (!obj)
+        {
+            fprintf(stderr, "Could not build the %s.\n", hb_cases[i].name);
+            exit(1);
+        }
+        obj = store_add(store, obj);
+        double seconds = hb_time(obj, base, dirs, passes, &hits);
+        hb_report(hb_cases[i].name, hb_cases[i].variant, seconds,
+                  (double)passes * HB_RAYS, (double)hits / HB_RAYS);
+    }
+    /* Scatters the spheres over the same square, at varying depths. */
+    obj_t* spheres[HB_SPHERES];
+    int ids[HB_SPHERES];
+    sbatch_t* batch = sbatch_init(HB_SPHERES);
+    for (int i = 0; i < HB_SPHERES; i++)
+    {
+        char text[BUFF_SIZE];
+        snprintf(text, BUFF_SIZE, "%s%f %f %f\n%f\n", HB_MATERIAL,
+                 (2 * rng_uniform(&rng) - 1) * HB_SPREAD,
+                 (2 * rng_uniform(&rng) - 1) * HB_SPREAD,
+                 -5 - 2 * rng_uniform(&rng), HB_RADIUS);
+        obj_t* obj = hb_build(text, sphere_init, SPHERE);
+        if (!obj)
+        {
+            fprintf(stderr, "Could not build the spheres.\n");
+            exit(1);
+        }
+        ids[i] = obj->objid;
+        sbatch_set(batch, i, (sphere_t*)obj->priv);
+        store_add(store, obj);
+    }
+    /* Looks the spheres up once the store has stopped growing. */
+    store_finish(store);
+    for (int i = 0; i < HB_SPHERES; i++)
+    {
+        spheres[i] = store_find(store, ids[i]);
+    }
+    double tests = (double)passes * HB_RAYS * HB_SPHERES;
+    double seconds = hb_time_scalar(spheres, base, dirs, passes, &hits);
+    hb_report("sphere", "scalar", seconds, tests,
+              (double)hits / (HB_RAYS * HB_SPHERES));
+    for (int isa = ISA_SCALAR; isa < ISA_COUNT; isa++)
+    {
+        if (sbatch_select(isa) == FAILURE)
+        {
+            continue;
+        }
+        char variant[BUFF_SIZE];
+        snprintf(variant, BUFF_SIZE, "batch-%s", cpu_isa_name(isa));
+        seconds = hb_time_batch(batch, base, dirs, passes, &hits);
+        hb_report("sphere", variant, seconds, tests,
+                  (double)hits / (HB_RAYS * HB_SPHERES));
+    }
+    sbatch_free(batch);
+    delete_store(store);
+    free(dirs);
+    return 0;
+}
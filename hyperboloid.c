@@ -15,29 +15,22 @@
  * Param: objtype  The object type of the object we are creating.
  * Return:  The new object that has been created.
  */
-obj_t* hyperb_init(FILE* in, int objtype)
+obj_t* hyperb_init(scene_in_t* in, int objtype)
 {
-    char buff[BUFF_SIZE];
     int pcount = 0;
     obj_t* obj = object_init(in, objtype);
     if (obj)
     {
         hyperb_t* hyperb = Malloc(sizeof(hyperb_t));
-        pcount += fscanf(in, "%lf %lf %lf",
-                         &hyperb->center[X], &hyperb->center[Y], &hyperb->center[Z]);
-        fgets(buff, BUFF_SIZE, in);
-        pcount += fscanf(in, "%lf %lf %lf",
-                         &hyperb->centerline[X], &hyperb->centerline[Y], 
-                         &hyperb->centerline[Z]);
-        fgets(buff, BUFF_SIZE, in);
-        pcount+= fscanf(in, "%lf %lf",
-                        &hyperb->radius, &hyperb->height);
-        fgets(buff, BUFF_SIZE, in);
-        pcount += fscanf(in, "%lf", &hyperb->radiusc);
-        fgets(buff, BUFF_SIZE, in);
+        pcount += scene_read(in, 3, &hyperb->center[X], &hyperb->center[Y],
+                             &hyperb->center[Z]);
+        pcount += scene_read(in, 3, &hyperb->centerline[X],
+                             &hyperb->centerline[Y], &hyperb->centerline[Z]);
+        pcount += scene_read(in, 2, &hyperb->radius, &hyperb->height);
+        pcount += scene_read(in, 1, &hyperb->radiusc);
         if (pcount == HYPER_OBJS)
         {
-            double id_matrix[XYZ][XYZ];
+            real_t id_matrix[XYZ][XYZ];
             get_id_matrix(id_matrix);
             /* Adjustment for shapes aligned with the negative y axis. This
              * is a minor hack to adjust for this bad case. */
@@ -58,7 +51,12 @@ obj_t* hyperb_init(FILE* in, int objtype)
             hyperb->scale = (pow(hyperb->radius, SQUARED) - 
                              pow(hyperb->radiusc, SQUARED)) 
                             / pow(hyperb->height, SQUARED);
-            obj->hits = hyperb_hits;
+            hyperb->radiusc_sq = pow(hyperb->radiusc, SQUARED);
+            hyperb->aligned = (hyperb->centerline[X] == 0 &&
+                               hyperb->centerline[Y] != 0 &&
+                               hyperb->centerline[Z] == 0);
+            obj->hits = hyperb->aligned ? hyperb_hits_aligned : hyperb_hits;
+            obj->cold->surface = hyperb_surface;
             obj->priv = hyperb;
         }
         else
@@ -71,7 +69,8 @@ obj_t* hyperb_init(FILE* in, int objtype)
 }
 
 /*
- * Function for determining if a ray hit a hyperboloid.
+ * Function for determining if a ray hit a hyperboloid. The ray is rotated
+ * into the hyperboloid's own space, where its centerline is the y axis.
  *
  * Param: base  The starting point for the ray.
  * Param: dir   The direction of the approaching ray.
@@ -80,38 +79,55 @@ obj_t* hyperb_init(FILE* in, int objtype)
  * Return: The distance from our viewpoint that the object is at, if we hit.
  *         If we miss, returns -1.
  */
-double hyperb_hits(double* base, double* dir_start, obj_t* obj)
+real_t hyperb_hits(real_t* base, real_t* dir_start, obj_t* obj)
 {
-    double t = MISS;
     hyperb_t* hyperb = (hyperb_t*)obj->priv;
-    double newbase[XYZ];
-    double newcenter[XYZ];
-    diff3(hyperb->center, base, newbase);
-    double dir[XYZ];
-    diff3(hyperb->center, hyperb->center, newcenter);
-    double idmat[XYZ][XYZ];
-    get_id_matrix(idmat);
-    if (!(hyperb->centerline[X] == idmat[Y][X] && hyperb->centerline[Y] != 0 &&
-          hyperb->centerline[Z] == idmat[Y][Z]))
-    {
-        transform(hyperb->rotmat, newbase, newbase);
-        transform(hyperb->rotmat, dir_start, dir);
-    }
-    else
-    {
-        transform(idmat, newbase, newbase);
-        transform(idmat, dir_start, dir);
-    }
-    double a = pow(dir[X], SQUARED) + pow(dir[Z], SQUARED) - hyperb->scale * 
-               pow(dir[Y], SQUARED);
-    double b = 2 * (newbase[X] * dir[X] + newbase[Z] * dir[Z] - 
-               hyperb->scale * newbase[Y] * dir[Y]);
-    double c = pow(newbase[X], SQUARED) + pow(newbase[Z], SQUARED) -
-               hyperb->scale * pow(newbase[Y], SQUARED) - 
-               pow(hyperb->radiusc, SQUARED);
-    double discrim = pow(b, SQUARED) - 4 * a * c;
-    double t1 = ((-1 * b) - sqrt(discrim))/(2 * a);
-    double t2 = ((-1 * b) + sqrt(discrim))/(2 * a);
+    vec3_t newbase = vec3_sub(vec3_load(base), vec3_load(hyperb->center));
+    return hyperb_solve(obj, vec3_xform(hyperb->rotmat, newbase),
+                        vec3_xform(hyperb->rotmat, vec3_load(dir_start)));
+}
+
+/*
+ * Function for determining if a ray hit a hyperboloid whose centerline is
+ * already the y axis, so only the translation is needed.
+ *
+ * Param: base  The starting point for the ray.
+ * Param: dir   The direction of the approaching ray.
+ * Param: obj   The hyperboloid object that is being tested for hits.
+ *
+ * Return: The distance from our viewpoint that the object is at, if we hit.
+ *         If we miss, returns -1.
+ */
+real_t hyperb_hits_aligned(real_t* base, real_t* dir, obj_t* obj)
+{
+    hyperb_t* hyperb = (hyperb_t*)obj->priv;
+    vec3_t newbase = vec3_sub(vec3_load(base), vec3_load(hyperb->center));
+    return hyperb_solve(obj, newbase, vec3_load(dir));
+}
+
+/*
+ * Solves for where a ray already in the hyperboloid's space meets it.
+ *
+ * Param: obj   The hyperboloid object being tested.
+ * Param: newbase  The start of the ray relative to the hyperboloid.
+ * Param: dir   The direction of the ray in the hyperboloid's space.
+ *
+ * Return: The distance to the closest hit, or MISS.
+ */
+real_t hyperb_solve(obj_t* obj, vec3_t newbase, vec3_t dir)
+{
+    real_t t = MISS;
+    hyperb_t* hyperb = (hyperb_t*)obj->priv;
+    real_t a = dir.x * dir.x + dir.z * dir.z - hyperb->scale *
+               (dir.y * dir.y);
+    real_t b = 2 * (newbase.x * dir.x + newbase.z * dir.z - 
+               hyperb->scale * newbase.y * dir.y);
+    real_t c = newbase.x * newbase.x + newbase.z * newbase.z -
+               hyperb->scale * (newbase.y * newbase.y) -
+               hyperb->radiusc_sq;
+    real_t discrim = b * b - 4 * a * c;
+    real_t t1 = ((-1 * b) - sqrt(discrim))/(2 * a);
+    real_t t2 = ((-1 * b) + sqrt(discrim))/(2 * a);
     t2 = (check_hyperb_hit (obj, dir, newbase, t2));
     t1 = (check_hyperb_hit (obj, dir, newbase, t1));
     if (t1 == MISS)
@@ -131,50 +147,90 @@ double hyperb_hits(double* base, double* dir_start, obj_t* obj)
 
 /*
  * Function for checking both the positive and negative side of the quadratic
- * hit function.
+ * hit function. Only the height of the hit is needed to decide, so the rest
+ * of the hit is left to hyperb_surface.
  *
- * Param: obj  The object to check hits with and store a hitpoint in.
+ * Param: obj  The object to check hits with.
  * Param: dir  The direction of the current ray.
  * Param: newbase  The base of the ray we are shooting.
  * Param: t  The current distance from the object.
  *
- * return:  The new t value, representing the distance from the object.
+ * Return:  The new t value, representing the distance from the object.
  */
-double check_hyperb_hit(obj_t* obj, double* dir, double* newbase, double t)
+real_t check_hyperb_hit(obj_t* obj, vec3_t dir, vec3_t newbase, real_t t)
 {
     hyperb_t* hyperb = (hyperb_t*)(obj->priv);
-    double hit[XYZ];
-    double scaled_d[XYZ];
-    scale3(t, dir, scaled_d);
-    sum3(newbase, scaled_d, hit);
-    if (hit[Y] > hyperb->height  || 
-        (hit[Y] < (hyperb->height + hyperb->height * -2)))
+    real_t hit_y = newbase.y + t * dir.y;
+    if (hit_y > hyperb->height  || 
+        (hit_y < (hyperb->height + hyperb->height * -2)))
     {
         t = MISS;
     }
-    else
+    return t;
+}
+
+/*
+ * Function for finding the hit location and normal on a hyperboloid. The ray is
+ * moved into the hyperboloid's space the same way the hits function moved it.
+ *
+ * Param: base  The starting point for the ray.
+ * Param: dir_start  The direction of the approaching ray.
+ * Param: t     The distance returned by the hits function.
+ * Param: obj   The hyperboloid object that was hit.
+ * Param: record  Output for the hit location and normal.
+ */
+void hyperb_surface(real_t* base, real_t* dir_start, real_t t, obj_t* obj,
+                    hit_t* record)
+{
+    hyperb_t* hyperb = (hyperb_t*)obj->priv;
+    vec3_t newbase = vec3_sub(vec3_load(base), vec3_load(hyperb->center));
+    vec3_t dir = vec3_load(dir_start);
+    if (!hyperb->aligned)
     {
-        double normal[XYZ];
-        double idmat[XYZ][XYZ];
-        get_id_matrix(idmat);
-        normal[X] = 2 * hit[X];
-        normal[Y] = -2 * hyperb->scale * hit[Y];
-        normal[Z] = 2 * hit[Z];
-        if (!(hyperb->centerline[X] == idmat[Y][X] && 
-              hyperb->centerline[Y] != 0 &&
-              hyperb->centerline[Z] == idmat[Y][Z]))
-        {
-            transform(hyperb->irot, hit, obj->hitloc);
-            transform(hyperb->irot, normal, obj->normal);
-        }
-        else
-        {
-            transform(idmat, hit, obj->hitloc);
-            transform(idmat, normal, obj->normal);
-        }
-        sum3(obj->hitloc, hyperb->center, obj->hitloc);
+        newbase = vec3_xform(hyperb->rotmat, newbase);
+        dir = vec3_xform(hyperb->rotmat, dir);
     }
-    return t;
+    vec3_t hit = vec3_along(newbase, dir, t);
+    vec3_t normal = vec3(2 * hit.x, -2 * hyperb->scale * hit.y,
+                           2 * hit.z);
+    if (!hyperb->aligned)
+    {
+        hit = vec3_xform(hyperb->irot, hit);
+        normal = vec3_xform(hyperb->irot, normal);
+    }
+    vec3_store(vec3_add(hit, vec3_load(hyperb->center)), record->hitloc);
+    vec3_store(normal, record->normal);
+}
+
+/*
+ * Function for finding the world space bounds of a hyperboloid, which can be
+ * hit between -height and height along its centerline. When it is pinched
+ * in the middle its widest points are the two end caps. Otherwise it is
+ * widest at the center, and the box is taken around a cylinder that wide.
+ *
+ * Param: obj  The hyperboloid object to bound.
+ * Param: box  The output box.
+ *
+ * Return: BOUNDED.
+ */
+int hyperb_bounds(obj_t* obj, bbox_t* box)
+{
+    hyperb_t* hyperb = (hyperb_t*)obj->priv;
+    real_t top[XYZ];
+    real_t bottom[XYZ];
+    real_t radius = fabs(hyperb->radiusc);
+    if (hyperb->scale > 0)
+    {
+        radius = sqrt(hyperb->scale * pow(hyperb->height, SQUARED) +
+                      pow(hyperb->radiusc, SQUARED));
+    }
+    scale3(hyperb->height, hyperb->rotmat[Y], top);
+    diff3(top, hyperb->center, bottom);
+    sum3(hyperb->center, top, top);
+    box_empty(box);
+    box_add_disc(box, bottom, hyperb->rotmat[Y], radius);
+    box_add_disc(box, top, hyperb->rotmat[Y], radius);
+    return BOUNDED;
 }
 
 /*
@@ -10,6 +10,8 @@
 
 /* Necessary for the obj_t struct. */
 #include "object.h"
+/* Necessary for the bbox_t struct. */
+#include "bbox.h"
 
 /* The correct number of items to read in for this object.*/
 #define HYPER_OBJS 9
@@ -27,24 +29,38 @@
  * Data Member: rotmat  The rotation matrix necessary for rotating this object
  *              to make hit detection easier.
  * Data Member: irot  The transpose of rotmat, for reversing the transformation.
+ * Data Member: radiusc_sq  The center radius squared, used on every hit test.
+ * Data Member: aligned  Nonzero when the centerline already points along +y,
+ *                       so rays need no rotation into the hyperboloid's space.
  */
 typedef struct hyperb_type
 {
-    double center[XYZ];
-    double centerline[XYZ];
-    double radius;
-    double radiusc;
-    double height;
-    double scale;
-    double rotmat[XYZ][XYZ];
-    double irot[XYZ][XYZ];
+    real_t center[XYZ];
+    real_t centerline[XYZ];
+    real_t radius;
+    real_t radiusc;
+    real_t height;
+    real_t scale;
+    real_t rotmat[XYZ][XYZ];
+    real_t irot[XYZ][XYZ];
+    real_t radiusc_sq;
+    int aligned;
 } hyperb_t;
 
-obj_t* hyperb_init(FILE* in, int objtype);
+obj_t* hyperb_init(scene_in_t* in, int objtype);
 
-double hyperb_hits(double* base, double* dir_start, obj_t* obj);
+real_t hyperb_hits(real_t* base, real_t* dir_start, obj_t* obj);
 
-double check_hyperb_hit(obj_t* obj, double* dir, double* newbase, double t);
+real_t hyperb_hits_aligned(real_t* base, real_t* dir, obj_t* obj);
+
+real_t hyperb_solve(obj_t* obj, vec3_t newbase, vec3_t dir);
+
+int hyperb_bounds(obj_t* obj, bbox_t* box);
+
+real_t check_hyperb_hit(obj_t* obj, vec3_t dir, vec3_t newbase, real_t t);
+
+void hyperb_surface(real_t* base, real_t* dir, real_t t, obj_t* obj,
+                    hit_t* record);
 
 void dump_hyperb(FILE* out, obj_t* obj);
 
@@ -9,31 +9,145 @@
 #include "illuminate.h"
 
 /* diffuse_illumination - This function loops through every cals process_light
- * to determine what it hits.
+ * to determine what it hits. The shading record is shared by every light.
+ * When the model samples its lights, only that many lights are drawn from
+ * the light tree instead, and each is weighted by the chance of drawing it,
+ * so that the sum is right on average and averages out over AA samples.
  *
  * Param: model - pointer to the model structure
- * Param: hitobj - object that was hit by the ray
+ * Param: hit - record of where the ray hit an object
+ * Param: shade - the material and unit normal at the hit
+ * Param: rng - generator the lights are drawn from when sampling
  * Param: intensity - where to add the intensity
  */
-void diffuse_illumination(model_t* model, obj_t* hitobj, 
-                          double intensity[RGB_SIZE])
+void diffuse_illumination(model_t* model, hit_t* hit, shade_t* shade,
+                          rng_t* rng, real_t intensity[RGB_SIZE])
 {
-    obj_t* node = model->lights->head;
-    while (node)
+    store_t* lights = model->lights;
+    obj_cold_t* cold = hit->obj->cold;
+    if (model->light_samples > 0)
     {
-        process_light(model->scene, hitobj, node, intensity);
-        node = node->next;
+        for (int i = 0; i < model->light_samples; i++)
+        {
+            real_t pdf;
+            int slot = ltree_sample(model->light_tree, lights, hit->hitloc,
+                                    shade->normal, rng, &pdf);
+            if (slot < 0)
+            {
+                continue;
+            }
+            real_t light[RGB_SIZE] = {0.0, 0.0, 0.0};
+            process_light(model, hit, shade, &lights->objs[slot], light);
+            real_t weight = 1 / (pdf * (real_t)model->light_samples);
+            intensity[R] += light[R] * weight;
+            intensity[G] += light[G] * weight;
+            intensity[B] += light[B] * weight;
+        }
+        return;
+    }
+    if (cold->lights)
+    {
+        for (int i = 0; i < cold->num_lights; i++)
+        {
+            process_light(model, hit, shade, &lights->objs[cold->lights[i]],
+                          intensity);
+        }
+        return;
+    }
+    for (int i = 0; i < lights->count; i++)
+    {
+        process_light(model, hit, shade, &lights->objs[i], intensity);
+    }
+}
+
+/*
+ * build_light_lists - This function finds, for every object in the scene,
+ *                     the lights that can reach it, so that lights which
+ *                     can never shine on an object are not tried for it.
+ *                     Only a light with a reach check can be left out, so
+ *                     nothing is built if there is none, or if the lights
+ *                     are sampled instead. Unbounded objects, and objects
+ *                     every light reaches, keep a NULL list for every light.
+ *                     The lists keep the order of the lights, so the light
+ *                     at a hit is added up in the same order either way.
+ *
+ * Param: model - pointer to the model structure
+ */
+void build_light_lists(model_t* model)
+{
+    store_t* lights = model->lights;
+    store_t* scene = model->scene;
+    int checked = FALSE;
+    for (int j = 0; j < lights->count; j++)
+    {
+        checked |= ((light_t*)lights->objs[j].priv)->reach_check != NULL;
+    }
+    if (!checked || model->light_samples > 0)
+    {
+        return;
+    }
+    /* Holds at least one list, so even an empty list is never NULL. */
+    size_t capacity = (size_t)lights->count;
+    size_t used = 0;
+    int* slots = Malloc(sizeof(int) * capacity);
+    for (int i = 0; i < scene->count; i++)
+    {
+        obj_cold_t* cold = scene->objs[i].cold;
+        bbox_t box;
+        /* Marks the object as taking every light until it is shown not to. */
+        cold->num_lights = -1;
+        if (object_bounds(&scene->objs[i], &box) != BOUNDED)
+        {
+            continue;
+        }
+        if (capacity - used < (size_t)lights->count)
+        {
+            capacity *= 2;
+            slots = Realloc(slots, sizeof(int) * capacity);
+        }
+        int kept = 0;
+        for (int j = 0; j < lights->count; j++)
+        {
+            light_t* light = (light_t*)lights->objs[j].priv;
+            if (!light->reach_check ||
+                light->reach_check(&lights->objs[j], &box))
+            {
+                slots[used + (size_t)kept++] = j;
+            }
+        }
+        if (kept < lights->count)
+        {
+            cold->num_lights = kept;
+            used += (size_t)kept;
+        }
     }
+    /* The array has stopped moving, so the lists can be pointed into it. */
+    int* next = slots;
+    for (int i = 0; i < scene->count; i++)
+    {
+        obj_cold_t* cold = scene->objs[i].cold;
+        if (cold->num_lights < 0)
+        {
+            cold->lights = NULL;
+            cold->num_lights = 0;
+            continue;
+        }
+        cold->lights = next;
+        next += cold->num_lights;
+    }
+    model->light_lists = slots;
 }
 
 /*
  * process_light - This function tries to determine if a light hits an object
  *                 by drawing a ray from the initial hitlocation from the 
  *                 initial ray from the viewer to the light that we are 
- *                 testing.
+ *                 testing. Only objects nearer than the light can block it,
+ *                 and the search stops at the first one found.
  *
- * Param: lst - list of all objects
- * Param hitobj - The object hit by the ray
+ * Param: model - pointer to the model structure
+ * Param: hit - record of where the ray hit an object
+ * Param: shade - the material and unit normal at the hit
  * Param: lobj - The current light source
  * Param: ivec - [r, g, b] intensity vector
  *
@@ -41,26 +155,24 @@ void diffuse_illumination(model_t* model, obj_t* hitobj,
  *
  */
 
-int process_light (list_t* lst, obj_t* hitobj, obj_t* lobj, 
-                    double ivec[RGB_SIZE])
+int process_light (model_t* model, hit_t* hit, shade_t* shade, obj_t* lobj,
+                    real_t ivec[RGB_SIZE])
 {
     int success = 0;
-    obj_t* closest = NULL;
-    double mindist = MISS;
-    double dir[DIMENSIONS];
+    obj_t* hitobj = hit->obj;
+    obj_t* blocker = NULL;
+    real_t dir[DIMENSIONS];
     light_t* light = (light_t*)lobj->priv;
-    diff3(hitobj->hitloc, light->location, dir);
-    double dist = sqrt(pow(dir[X], SQUARED) + pow(dir[Y], SQUARED) + 
-                  pow(dir[Z], SQUARED));
-    double hitobj_unit[DIMENSIONS];
-    double dir_unit[DIMENSIONS];
-    unitvec3(hitobj->normal, hitobj_unit);
-    unitvec3(dir, dir_unit);
-    double theta = dot3(dir_unit, hitobj_unit);
+    vec3_t to_light = vec3_sub(vec3_load(light->location),
+                               vec3_load(hit->hitloc));
+    vec3_store(to_light, dir);
+    real_t dist = vec3_length(to_light);
+    vec3_t unit_to_light = vec3_unit(to_light);
+    real_t theta = vec3_dot(unit_to_light, vec3_load(shade->normal));
     #ifdef DBG_DIFFUSE
         fprintf(stderr, "hit object id was       %d\n", hitobj->objid);
-        vecprnN("hit point was            \n", hitobj->hitloc, DIMENSIONS);
-        vecprnN("normal at hitpoint       \n", hitobj-> normal, DIMENSIONS);
+        vecprnN("hit point was            \n", hit->hitloc, DIMENSIONS);
+        vecprnN("normal at hitpoint       \n", hit->normal, DIMENSIONS);
         fprintf(stderr, "light object id was      %d\n", lobj->objid);
         vecprnN("light center was         \n", light->location, DIMENSIONS);
         vecprnN("unit vector to light is  \n", dir, DIMENSIONS);
@@ -69,17 +181,23 @@ int process_light (list_t* lst, obj_t* hitobj, obj_t* lobj,
     #endif
     if (theta > 0)
     {
-        closest = find_closest_object(lst, hitobj->hitloc, dir, hitobj, 
-                                      &mindist);
+        /* Spotlights turn away points outside their cone before any shadow
+         * ray is traced. */
         int flag = 1;
         if(light->illum_check)
         {
-            flag = light->illum_check(lobj, hitobj->hitloc);
+            real_t to_hit[DIMENSIONS];
+            vec3_store(vec3_scale(unit_to_light, -1), to_hit);
+            flag = light->illum_check(lobj, to_hit);
+        }
+        if (flag)
+        {
+            STAT_RAY(RAY_SHADOW);
+            blocker = find_occluder(model, hit->hitloc, dir, hitobj, dist);
         }
-        if ((!closest || (mindist != MISS && mindist > dist)) && flag)
+        if (!blocker && flag)
         {
-            double diffuse[RGB_SIZE];
-            hitobj->getdiff(hitobj, diffuse);
+            real_t* diffuse = shade->diffuse;
             *(ivec + 0) += diffuse[R] * light->emissivity[R] * theta / dist;
             *(ivec + 1) += diffuse[G] * light->emissivity[G] * theta / dist;
             *(ivec + 2) += diffuse[B] * light->emissivity[B] * theta / dist;
@@ -88,7 +206,7 @@ int process_light (list_t* lst, obj_t* hitobj, obj_t* lobj,
                 vecprnN("Emissivity of the light    \n", light->emissivity, 
                                                          DIMENSIONS);
                 vecprnN("Diffuse reflectivity       \n", 
-                         hitobj->material.diffuse, DIMENSIONS);
+                         shade->diffuse, DIMENSIONS);
                 vecprnN("Current ivec               \n", ivec, DIMENSIONS);
             #endif
         }
@@ -96,8 +214,7 @@ int process_light (list_t* lst, obj_t* hitobj, obj_t* lobj,
         {
             #ifdef DBG_DIFFUSE
                 fprintf(stderr, "\nhit object occluded by %d\n", 
-                        closest->objid);
-                fprintf(stderr, "\ndistance was %f\n", mindist);
+                        blocker ? blocker->objid : -1);
             #endif
         }
     }
@@ -10,8 +10,8 @@
 
 /* Included for the obj_t typedef. */
 #include "object.h"
-/* Included so that we can iterate through lists. */
-#include "linked_list.h"
+/* Included so that we can iterate through stores. */
+#include "store.h"
 /* Included so that we can access the model object in diffuse_illumination() */
 #include "model.h"
 /* Used so that we can calculate unit vecs and differences. */
@@ -19,6 +19,10 @@
 /* Included so that we may call the closest_object function. */
 #include "raytrace.h"
 
-void diffuse_illumination(model_t* model, obj_t* hitobj, double* intensity);
+void diffuse_illumination(model_t* model, hit_t* hit, shade_t* shade,
+                          rng_t* rng, real_t intensity[RGB_SIZE]);
 
-int process_light (list_t* lst, obj_t* hitobj, obj_t* lobj, double* ivec);
+void build_light_lists(model_t* model);
+
+int process_light (model_t* model, hit_t* hit, shade_t* shade, obj_t* lobj,
+                   real_t ivec[RGB_SIZE]);
@@ -15,72 +15,94 @@
  * Param: proj   The projection containing the world size and viewpoint.
  * Param: x      The x dimension of the pix coordinate to translate.
  * Param: y      The y dimension of the pix coordinate to translate.
+ * Param: rng    The generator used to jitter this sample, or NULL to aim at
+ *               the pixel itself.
  * Param: world  The array to store the returned coordinates in.
  */
 
-void map_pix_to_world(proj_t* proj, int x, int y, double* world)
+void map_pix_to_world(proj_t* proj, int x, int y, rng_t* rng, real_t* world)
 {
-    double rx = (double)x;
-    double ry = (double)y;
-    #ifdef AA
-        rx = randpix(x);
-        ry = randpix(y);
-    #endif
+    real_t rx = (real_t)x;
+    real_t ry = (real_t)y;
+    if (rng)
+    {
+        rx = randpix((real_t)x, rng);
+        ry = randpix((real_t)y, rng);
+    }
 
     /* Transforms x pixel coordinate into x world coordinate. */
-    *(world + X) = (double)(rx) / (proj->win_size_pixel[X] - 1) * 
+    *(world + X) = (real_t)(rx) / (real_t)(proj->win_size_pixel[X] - 1) * 
                     proj->win_size_world[X];
     *(world + X) -= proj->win_size_world[X] / 2.0;
     /* Transforms y pixel coordinate into y world coordinate. */
-    *(world + Y) = (double)(ry) / (proj->win_size_pixel[Y] - 1) * 
+    *(world + Y) = (real_t)(ry) / (real_t)(proj->win_size_pixel[Y] - 1) * 
                     proj->win_size_world[Y];
     *(world + Y) -= proj->win_size_world[Y] / 2.0;
     /* We assume z is 0 for simplicity. */
     *(world + Z) = 0.0;
 }
 
-double randpix(double x)
+/*
+ * Jitters a pixel coordinate for anti-aliasing.
+ *
+ * Param: x    The pixel coordinate to jitter.
+ * Param: rng  The generator for the current sample.
+ * Return: The coordinate moved by a random amount in [-.5, .5).
+ */
+real_t randpix(real_t x, rng_t* rng)
 {
-    return x + (((double)random()/RAND_MAX) * 1.5) - .5;
+    return x + (real_t)rng_uniform(rng) - (real_t)0.5;
 }
 
 /*
- * This function creates a pixel from the information returned by a call to
- * ray_trace. We calculate the value of "intensity", the intensity of 
- * the red, green, and blue values for each pixel.
+ * Traces a single ray from the viewpoint through a pixel.
  *
  * Param: model  The model containing necessary projection information.
- * Param: x      The x dimension of the pixel we are creating.
- * Param: y      The y dimension of the pixel we are creating.
- * Param: pixval The output pixel for this function.
+ * Param: x      The x dimension of the pixel.
+ * Param: y      The y dimension of the pixel.
+ * Param: rng    The generator used to jitter the ray, or NULL for none.
+ *               It also draws the lights when the model samples them,
+ *               from a generator for the pixel if there is none.
+ * Param: intensity  Output for the unclamped color seen along the ray.
+ *
+ * Return: The object the ray hit first, or NULL if it hit nothing.
  */
-void make_pixel(model_t *model, int x, int y, unsigned char *pixval)
+obj_t* trace_sample(model_t* model, int x, int y, rng_t* rng,
+                    real_t intensity[RGB_SIZE])
 {
-    srand((unsigned)time(0));
-    double world[DIMENSIONS];
-    double intensity[RGB_SIZE];
-    /* Finds world coordinates of pixel. */
+    real_t world[DIMENSIONS];
+    real_t dir[DIMENSIONS];
     intensity[R] = 0;
     intensity[G] = 0;
     intensity[B] = 0;
-    double* dir = Malloc(sizeof(double) * DIMENSIONS);
-    for (int i = 0; i < AA_SAMPLES; i++)
-    {
-        map_pix_to_world(model->proj, x, y, world);
-        diff3(model->proj->view_point, world, dir);
-        unitvec3(dir, dir);
-        /* Finds the closest object that we hit.*/
-        ray_trace(model, model->proj->view_point, dir, intensity, 0.0, NULL);
-    }
-    free(dir);
-    //fprintf(stderr, "R: %f G: %f B: %f\n", intensity[R], intensity[G], intensity[B]);
-    //scale3(1/AA_SAMPLES, intensity, intensity);
+    /* Finds world coordinates of pixel. */
+    map_pix_to_world(model->proj, x, y, rng, world);
     #ifdef DBG_WORLD
         fprintf(stderr, "WRL (%5.11f, %5.11f) - ", world[X], world[Y]);
     #endif
-    
     /* Calculates a unit vector representing the direction from the viewer to
      * the pixel. */
+    vec3_store(vec3_unit(vec3_sub(vec3_load(world),
+                                  vec3_load(model->proj->view_point))), dir);
+    /* Unjittered rays still need their own draws when lights are sampled. */
+    rng_t pixel_rng;
+    if (!rng && model->light_samples > 0)
+    {
+        rng_seed(&pixel_rng, model->seed, x, y, 0);
+        rng = &pixel_rng;
+    }
+    /* Finds the closest object that we hit.*/
+    STAT_RAY(RAY_PRIMARY);
+    return ray_trace(model, model->proj->view_point, dir, intensity, 0.0,
+                     NULL, rng);
+}
+
+/*
+ * Clamps a color into the displayable range.
+ * Param: intensity  The color to clamp in place.
+ */
+void clamp_color(real_t intensity[RGB_SIZE])
+{
     /* Clamps values over 1 back down to 1 in order to stay under 255 colors. */
     intensity[R] = intensity[R] > 1 ? 1 : intensity[R];
     intensity[G] = intensity[G] > 1 ? 1 : intensity[G];
@@ -89,12 +111,272 @@ void make_pixel(model_t *model, int x, int y, unsigned char *pixval)
     intensity[R] = intensity[R] < 0 ? 0 : intensity[R];
     intensity[G] = intensity[G] < 0 ? 0 : intensity[G];
     intensity[B] = intensity[B] < 0 ? 0 : intensity[B];
+}
+
+/*
+ * Converts a color into the bytes of a pixel.
+ *
+ * Param: intensity  The color to convert. It is clamped in place.
+ * Param: pixval     The output pixel.
+ */
+void store_pixel(real_t intensity[RGB_SIZE], unsigned char* pixval)
+{
+    clamp_color(intensity);
     /* Calculates the RGB colors and places them back into the return array. */
     pixval[R] = (unsigned char)(intensity[R] * MAX_COLORS);
     pixval[G] = (unsigned char)(intensity[G] * MAX_COLORS); 
     pixval[B] = (unsigned char)(intensity[B] * MAX_COLORS); 
 }
 
+/*
+ * This function creates a pixel from the information returned by a call to
+ * ray_trace. We calculate the value of "intensity", the intensity of 
+ * the red, green, and blue values for each pixel.
+ *
+ * Param: model  The model containing necessary projection information.
+ * Param: x      The x dimension of the pixel we are creating.
+ * Param: y      The y dimension of the pixel we are creating.
+ * Param: pixval The output pixel for this function.
+ */
+void make_pixel(model_t *model, int x, int y, unsigned char *pixval)
+{
+    real_t intensity[RGB_SIZE];
+    trace_sample(model, x, y, NULL, intensity);
+    store_pixel(intensity, pixval);
+}
+
+/*
+ * Finds where a pixel is stored in the pixmap. The image is built from the
+ * bottom left, so the bottom row is stored last.
+ *
+ * Param: proj  The projection holding the window size.
+ * Param: x     The x dimension of the pixel.
+ * Param: y     The y dimension of the pixel.
+ *
+ * Return: The index of the pixel's first byte.
+ */
+int pixel_offset(proj_t* proj, int x, int y)
+{
+    return ((proj->win_size_pixel[Y] - (y + 1)) * proj->win_size_pixel[X] + x)
+           * RGB_SIZE;
+}
+
+/*
+ * Draws one pixel straight into the pixmap, without anti-aliasing.
+ *
+ * Param: model  The model being drawn.
+ * Param: image  The pixmap.
+ * Param: x      The x dimension of the pixel.
+ * Param: y      The y dimension of the pixel.
+ */
+void draw_pixel(model_t* model, void* image, int x, int y)
+{
+    unsigned char* pixmap = (unsigned char*)image;
+    make_pixel(model, x, y, &pixmap[pixel_offset(model->proj, x, y)]);
+}
+
+/*
+ * Traces one jittered sample of a pixel. Each sample has its own sequence,
+ * so the order pixels are drawn in never changes the image.
+ *
+ * Param: model  The model being drawn.
+ * Param: x      The x dimension of the pixel.
+ * Param: y      The y dimension of the pixel.
+ * Param: index  The index of the sample within the pixel.
+ * Param: color  Output for the color of the sample, clamped unless lights
+ *               are sampled. A sampled light is scaled up by how unlikely
+ *               it was to be drawn, so clamping it before the samples are
+ *               averaged would darken any pixel that is near saturated.
+ *
+ * Return: The object the sample hit first, or NULL if it hit nothing.
+ */
+obj_t* aa_sample(model_t* model, int x, int y, int index,
+                 real_t color[RGB_SIZE])
+{
+    rng_t rng;
+    rng_seed(&rng, model->seed, x, y, index);
+    obj_t* obj = trace_sample(model, x, y, &rng, color);
+    if (model->light_samples == 0)
+    {
+        clamp_color(color);
+    }
+    return obj;
+}
+
+/*
+ * Adds a sample's color to the running totals of a pixel.
+ *
+ * Param: pixel  The pixel to add to.
+ * Param: color  The color of the sample.
+ */
+void aa_accumulate(aa_pixel_t* pixel, real_t color[RGB_SIZE])
+{
+    for (int i = 0; i < RGB_SIZE; i++)
+    {
+        pixel->sum[i] += color[i];
+        pixel->sum_sq[i] += color[i] * color[i];
+    }
+    pixel->samples++;
+}
+
+/*
+ * Decides if the mean color of a pixel is still too uncertain. The variance
+ * of the mean is the sample variance divided by the number of samples.
+ *
+ * Param: pixel  The pixel to check.
+ * Return: TRUE if any channel of the mean varies more than AA_TOLERANCE.
+ */
+int aa_noisy(aa_pixel_t* pixel)
+{
+    real_t n = (real_t)pixel->samples;
+    if (pixel->samples < 2)
+    {
+        return FALSE;
+    }
+    for (int i = 0; i < RGB_SIZE; i++)
+    {
+        real_t var = (pixel->sum_sq[i] - pixel->sum[i] * pixel->sum[i] / n) /
+                     (n - 1);
+        if (var / n > AA_TOLERANCE)
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/*
+ * Compares the first pass results of two neighboring pixels.
+ *
+ * Param: pixel  The pixel being refined.
+ * Param: other  One of its neighbors.
+ * Return: TRUE if they first hit different objects or their colors differ by
+ *         more than AA_CONTRAST.
+ */
+int aa_differs(aa_pixel_t* pixel, aa_pixel_t* other)
+{
+    if (pixel->objid != other->objid)
+    {
+        return TRUE;
+    }
+    for (int i = 0; i < RGB_SIZE; i++)
+    {
+        if (fabs(pixel->first[i] - other->first[i]) > AA_CONTRAST)
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/*
+ * The first anti-aliasing pass. Takes the initial samples of a pixel and
+ * notes which object they hit.
+ *
+ * Param: model  The model being drawn.
+ * Param: image  The aa_image_t being built.
+ * Param: x      The x dimension of the pixel.
+ * Param: y      The y dimension of the pixel.
+ */
+void aa_first_pass(model_t* model, void* image, int x, int y)
+{
+    aa_image_t* aa = (aa_image_t*)image;
+    aa_pixel_t* pixel = &aa->pixels[y * model->proj->win_size_pixel[X] + x];
+    real_t color[RGB_SIZE];
+    memset(pixel, 0, sizeof(aa_pixel_t));
+    for (int i = 0; i < model->aa_initial; i++)
+    {
+        obj_t* obj = aa_sample(model, x, y, i, color);
+        int objid = obj ? obj->objid : AA_NO_OBJECT;
+        if (i == 0)
+        {
+            pixel->objid = objid;
+        }
+        else if (objid != pixel->objid)
+        {
+            pixel->mixed = TRUE;
+        }
+        aa_accumulate(pixel, color);
+    }
+    for (int i = 0; i < RGB_SIZE; i++)
+    {
+        pixel->first[i] = pixel->sum[i] / (real_t)pixel->samples;
+    }
+}
+
+/*
+ * The second anti-aliasing pass. A pixel is refined when its samples hit
+ * different objects, when a neighbor differs from it after the first pass,
+ * or while its color is too noisy, up to aa_max samples. The mean is then
+ * written to the pixmap. Only first pass results are read from neighbors,
+ * so pixels may be refined in any order.
+ *
+ * Param: model  The model being drawn.
+ * Param: image  The aa_image_t being built.
+ * Param: x      The x dimension of the pixel.
+ * Param: y      The y dimension of the pixel.
+ */
+void aa_refine_pass(model_t* model, void* image, int x, int y)
+{
+    aa_image_t* aa = (aa_image_t*)image;
+    int width = model->proj->win_size_pixel[X];
+    int height = model->proj->win_size_pixel[Y];
+    aa_pixel_t* pixel = &aa->pixels[y * width + x];
+    int edge = pixel->mixed;
+    if (x > 0 && aa_differs(pixel, pixel - 1))
+        edge = TRUE;
+    if (x < width - 1 && aa_differs(pixel, pixel + 1))
+        edge = TRUE;
+    if (y > 0 && aa_differs(pixel, pixel - width))
+        edge = TRUE;
+    if (y < height - 1 && aa_differs(pixel, pixel + width))
+        edge = TRUE;
+    real_t color[RGB_SIZE];
+    while (pixel->samples < model->aa_max && (edge || aa_noisy(pixel)))
+    {
+        aa_sample(model, x, y, pixel->samples, color);
+        aa_accumulate(pixel, color);
+    }
+    for (int i = 0; i < RGB_SIZE; i++)
+    {
+        color[i] = pixel->sum[i] / (real_t)pixel->samples;
+    }
+    store_pixel(color, &aa->pixmap[pixel_offset(model->proj, x, y)]);
+}
+
+/*
+ * Runs a pixel function over every pixel of the image, on the tile renderer
+ * when more than one thread was asked for.
+ *
+ * Param: model  The model being drawn.
+ * Param: draw   The function to run for every pixel.
+ * Param: image  The buffer handed to draw.
+ *
+ * Return: The number of allocations made while drawing.
+ */
+unsigned long render_pixels(model_t* model, pixel_fn_t draw, void* image)
+{
+    if (model->threads > 1)
+    {
+        return render_tiles(model, draw, image, model->threads);
+    }
+    unsigned long allocs = alloc_count();
+    /* We work our way across the row, and then the next iteration we hop
+     * back up a row and repeat, to build from bottom left. */
+    for (int y = 0; y < model->proj->win_size_pixel[Y]; y++)
+    {
+        for (int x = 0; x < model->proj->win_size_pixel[X]; x++)
+        {
+            #ifdef DBG_PIX
+                fprintf(stderr, "\nPIX %4d %4d - ", x, y);
+            #endif
+            draw(model, image, x, y);
+        }
+    }
+    stats_flush();
+    return alloc_count() - allocs;
+}
+
 /*
  * The function used for actually creating (through function calls) 
  * and writing the image. We build the image pixel by pixel, starting at the
@@ -110,22 +392,29 @@ void make_image(model_t* model)
     ppm_size *=    (int)model->proj->win_size_pixel[X];
     ppm_size *=    (int)model->proj->win_size_pixel[Y];
     pixmap = Malloc(sizeof(unsigned char) * (size_t)ppm_size);
-    for (int y = 0; y < model->proj->win_size_pixel[Y]; y++)
+    /* Counts the allocations made while drawing, which should be none. */
+    unsigned long allocs;
+    double start = stats_clock();
+    if (model->aa_initial > 0)
     {
-        /* Sets memory address to the far bottom left first, to represent the
-         * pixel. We work our way across the row, and then the next iteration
-         * we hop back up a row and repeat, to build from bottom left. */
-        int counter = (model->proj->win_size_pixel[Y] - (y + 1)) *
-                  (model->proj->win_size_pixel[X] * RGB_SIZE );
-        for (int x = 0; x < model->proj->win_size_pixel[X]; x++)
-        {
-            #ifdef DBG_PIX
-                fprintf(stderr, "\nPIX %4d %4d - ", x, y);
-            #endif
-            make_pixel(model, x, y, &pixmap[counter]);
-            counter = counter + RGB_SIZE;
-         }
+        /* The refining pass reads the first pass's results for the
+         * neighbors, so the passes run one after the other. */
+        aa_image_t aa;
+        aa.pixmap = pixmap;
+        aa.pixels = Malloc(sizeof(aa_pixel_t) *
+                           (size_t)model->proj->win_size_pixel[X] *
+                           (size_t)model->proj->win_size_pixel[Y]);
+        allocs = render_pixels(model, aa_first_pass, &aa);
+        allocs += render_pixels(model, aa_refine_pass, &aa);
+        free(aa.pixels);
+    }
+    else
+    {
+        allocs = render_pixels(model, draw_pixel, pixmap);
     }
+    stats_phase(PHASE_RENDER, start);
+    stats_allocations(allocs);
+    start = stats_clock();
     /* Open our output file. */
     /* Create, write, and free out PPM header info. */
     char* header = Calloc(BUFF_SIZE, sizeof(char));
@@ -141,5 +430,7 @@ void make_image(model_t* model)
     #endif
     /* Write our pixelmap to the file, and free. */
     fwrite(pixmap, sizeof(unsigned char), (size_t)ppm_size, stdout);
+    fflush(stdout);
     free(pixmap);
+    stats_phase(PHASE_WRITE, start);
 }
@@ -16,21 +16,90 @@
  * images. */
 #include "raytrace.h"
 
-/* Included for anti-aliasing. */
-#include <time.h>
+/* Includes render_tiles, used when drawing on more than one thread. */
+#include "tiles.h"
 
-/* Number of AA samples if defined */
-#ifdef AA
-    #define AA_SAMPLES 8
-#endif
-#ifndef AA
-    #define AA_SAMPLES 1
-#endif
+/* Included for memset, used to clear anti-aliasing totals. */
+#include <string.h>
 
-void map_pix_to_world(proj_t* proj, int x, int y, double* world);
+/* Initial number of anti-aliasing samples per pixel. 0 turns AA off. */
+#define AA_INITIAL 0
+
+/* Default ratio of the largest number of samples to the initial number. */
+#define AA_MAX_FACTOR 4
+
+/* Largest variance of a pixel's mean color before it is refined further. */
+#define AA_TOLERANCE 1e-4
+
+/* Largest difference in any channel between the first pass colors of two
+ * neighboring pixels before both are refined. */
+#define AA_CONTRAST 0.05
+
+/* The object ID recorded for samples that hit nothing. */
+#define AA_NO_OBJECT -1
+
+/*
+ * The running totals for one pixel while it is anti-aliased.
+ *
+ * Data Member: sum  The sum of the sample colors.
+ * Data Member: sum_sq  The sum of the squared sample colors.
+ * Data Member: first  The mean color after the first pass.
+ * Data Member: samples  The number of samples taken.
+ * Data Member: objid  The object hit by the first sample, or AA_NO_OBJECT.
+ * Data Member: mixed  Set when the initial samples hit different objects.
+ */
+typedef struct aa_pixel_type
+{
+    real_t sum[RGB_SIZE];
+    real_t sum_sq[RGB_SIZE];
+    real_t first[RGB_SIZE];
+    int samples;
+    int objid;
+    int mixed;
+} aa_pixel_t;
+
+/*
+ * An image being anti-aliased.
+ *
+ * Data Member: pixels  The totals for every pixel, bottom row first.
+ * Data Member: pixmap  The output image.
+ */
+typedef struct aa_image_type
+{
+    aa_pixel_t* pixels;
+    unsigned char* pixmap;
+} aa_image_t;
+
+void map_pix_to_world(proj_t* proj, int x, int y, rng_t* rng, real_t* world);
+
+real_t randpix(real_t x, rng_t* rng);
+
+obj_t* trace_sample(model_t* model, int x, int y, rng_t* rng,
+                    real_t intensity[RGB_SIZE]);
+
+void clamp_color(real_t intensity[RGB_SIZE]);
+
+void store_pixel(real_t intensity[RGB_SIZE], unsigned char* pixval);
 
 void make_pixel(model_t *model, int x, int y, unsigned char *pixval);
 
-void make_image(model_t* model);
+int pixel_offset(proj_t* proj, int x, int y);
+
+void draw_pixel(model_t* model, void* image, int x, int y);
+
+obj_t* aa_sample(model_t* model, int x, int y, int index,
+                 real_t color[RGB_SIZE]);
+
+void aa_accumulate(aa_pixel_t* pixel, real_t color[RGB_SIZE]);
 
-double randpix(double x);
+int aa_noisy(aa_pixel_t* pixel);
+
+int aa_differs(aa_pixel_t* pixel, aa_pixel_t* other);
+
+void aa_first_pass(model_t* model, void* image, int x, int y);
+
+void aa_refine_pass(model_t* model, void* image, int x, int y);
+
+unsigned long render_pixels(model_t* model, pixel_fn_t draw, void* image);
+
+void make_image(model_t* model);
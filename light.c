@@ -19,23 +19,16 @@
  *
  * Return: obj   The object that was just constructed and initialized.
  */
-obj_t* light_init(FILE* in, int objtype)
+obj_t* light_init(scene_in_t* in, int objtype)
 {
-    char buff[BUFF_SIZE];
     obj_t* obj = NULL;
     int pcount = 0;
     obj = object_init(in, objtype);
     light_t* light = Malloc(sizeof(light_t));
-    pcount += fscanf(in, "%lf %lf %lf",
-                     &(light->emissivity[X]),
-                     &(light->emissivity[Y]),
-                     &(light->emissivity[Z]));
-    fgets(buff, BUFF_SIZE, in);
-    pcount += fscanf(in, "%lf %lf %lf",
-                     &(light->location[X]),
-                     &(light->location[Y]),
-                     &(light->location[Z]));
-    fgets(buff, BUFF_SIZE, in);
+    pcount += scene_read(in, 3, &(light->emissivity[X]),
+                         &(light->emissivity[Y]), &(light->emissivity[Z]));
+    pcount += scene_read(in, 3, &(light->location[X]), &(light->location[Y]),
+                         &(light->location[Z]));
     if (pcount != LIGHT_OBJS || obj == NULL)
     {
         fprintf(stderr, "Error found in light_init...");
@@ -46,6 +39,7 @@ obj_t* light_init(FILE* in, int objtype)
         obj->priv = (void*)light;
         light->getemiss = default_getemiss;
         light->illum_check = NULL;
+        light->reach_check = NULL;
     }
     return obj;
 }
@@ -55,7 +49,7 @@ obj_t* light_init(FILE* in, int objtype)
  * Param: light  The light to copy emissivity from.
  * Param: value  The output vector.
  */
-void default_getemiss(light_t* light, double* value)
+void default_getemiss(light_t* light, real_t* value)
 {
     copy3(light->emissivity, value);
 }
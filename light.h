@@ -17,6 +17,9 @@
 /* Includes object structs and necessary definitions. */
 #include "object.h"
 
+/* Includes the bbox_t struct that lights are checked against. */
+#include "bbox.h"
+
 /*
  * The light_type struct for use in private data in object structs.
  * Contains the location of the light in the world.
@@ -27,19 +30,27 @@
  *                    such as a spotlight.
  * Function Member: getemiss Function pointer used to return the emissivity
  *                           of this object.
+ * Function Member: illum_check  Decides if the light shines towards a point,
+ *                               given the unit vector from the light to it,
+ *                               or NULL if it shines every way.
+ * Function Member: reach_check  Decides if the light could shine on any
+ *                               point of a box, or NULL if it reaches every
+ *                               box. It may say yes when it doesn't, but
+ *                               never the other way around.
  */
 typedef struct light_type
 {
-    double emissivity[RGB_SIZE];
-    double location[DIMENSIONS];
+    real_t emissivity[RGB_SIZE];
+    real_t location[DIMENSIONS];
     void* priv;
-    void    (*getemiss)(struct light_type*, double *);
-    int     (*illum_check)(obj_t* lobj, double* hitloc);
+    void    (*getemiss)(struct light_type*, real_t *);
+    int     (*illum_check)(obj_t* lobj, real_t* to_hit);
+    int     (*reach_check)(obj_t* lobj, bbox_t* box);
 } light_t;
 
-obj_t* light_init(FILE* in, int objtype);
+obj_t* light_init(scene_in_t* in, int objtype);
 
-void default_getemiss(light_t* light, double* value);
+void default_getemiss(light_t* light, real_t* value);
 
 void dump_light(FILE* out, obj_t* obj);
 
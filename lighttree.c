@@ -0,0 +1,343 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This file contains logic for building a light tree over the lights of a
+ * scene, and for walking it to pick one light for a point being shaded. Each
+ * step down the tree takes one of the two branches with a chance that
+ * follows how much light the branch could send to the point, so a light is
+ * picked about as often as it matters there. The chance of the whole walk
+ * is handed back, so that a caller can divide by it and stay unbiased.
+ */
+
+/* Header file for this source file. */
+#include "lighttree.h"
+/* Included for the inline vector functions. */
+#include "vec3.h"
+
+/*
+ * Finds the cone a light shines into. Spotlights shine into their own cone
+ * and every other light shines every way.
+ *
+ * Param: lobj  The light.
+ * Param: axis  Output for the unit centerline of the cone.
+ *
+ * Return: The half-width of the cone in radians.
+ */
+static real_t ltree_light_cone(obj_t* lobj, real_t* axis)
+{
+    light_t* light = (light_t*)lobj->priv;
+    if (lobj->objtype != SPOTLIGHT)
+    {
+        vec3_store(vec3(0, 0, 1), axis);
+        return (real_t)M_PI;
+    }
+    spotlight_t* spot = (spotlight_t*)light->priv;
+    vec3_store(vec3_load(spot->unit_dir), axis);
+    return spot->theta * (real_t)M_PI / HALF_CIRCLE;
+}
+
+/*
+ * Bounds the directions the lights of a node shine in with one cone, around
+ * the average of their centerlines. It is never narrower than it should be,
+ * though it may be wider.
+ *
+ * Param: node    The node to set the cone of.
+ * Param: lights  The store of lights.
+ * Param: slots   The slots of the lights of the node.
+ * Param: count   The number of lights of the node.
+ */
+static void ltree_node_cone(ltree_node_t* node, store_t* lights, int* slots,
+                            int count)
+{
+    vec3_t sum = vec3(0, 0, 0);
+    node->spread = 0;
+    for (int i = 0; i < count; i++)
+    {
+        real_t axis[XYZ];
+        real_t spread = ltree_light_cone(&lights->objs[slots[i]], axis);
+        node->spread = spread > node->spread ? spread : node->spread;
+        sum = vec3_add(sum, vec3_load(axis));
+    }
+    real_t length = vec3_length(sum);
+    if (node->spread >= (real_t)M_PI || length <= 0)
+    {
+        vec3_store(vec3(0, 0, 1), node->axis);
+        node->spread = (real_t)M_PI;
+        return;
+    }
+    vec3_t axis = vec3_scale(sum, 1 / length);
+    vec3_store(axis, node->axis);
+    node->spread = 0;
+    for (int i = 0; i < count; i++)
+    {
+        real_t light_axis[XYZ];
+        real_t spread = ltree_light_cone(&lights->objs[slots[i]], light_axis);
+        real_t cosine = vec3_dot(axis, vec3_load(light_axis));
+        spread += acos(cosine > 1 ? 1 : cosine < -1 ? -1 : cosine);
+        node->spread = spread > node->spread ? spread : node->spread;
+    }
+    node->spread = node->spread > (real_t)M_PI ? (real_t)M_PI : node->spread;
+}
+
+/*
+ * Recursively builds the nodes over the lights in slots[start, end). Each
+ * cluster is split at the middle of its widest axis, or in half once the
+ * lights can't be told apart that way.
+ *
+ * Param: tree    The tree being built.
+ * Param: lights  The store of lights.
+ * Param: slots   The slots of the lights, reordered in place.
+ * Param: start   The first light of this node.
+ * Param: end     One past the last light of this node.
+ * Param: depth   The depth of this node in the tree.
+ *
+ * Return: The index of the node that was built.
+ */
+static int ltree_build_node(ltree_t* tree, store_t* lights, int* slots,
+                            int start, int end, int depth)
+{
+    int index = tree->num_nodes++;
+    ltree_node_t* node = &tree->nodes[index];
+    box_empty(&node->box);
+    node->power = 0;
+    for (int i = start; i < end; i++)
+    {
+        light_t* light = (light_t*)lights->objs[slots[i]].priv;
+        box_add_point(&node->box, light->location);
+        node->power += light->emissivity[R] + light->emissivity[G] +
+                       light->emissivity[B];
+    }
+    vec3_t low = vec3_load(node->box.min);
+    vec3_t high = vec3_load(node->box.max);
+    vec3_store(vec3_scale(vec3_add(low, high), 0.5), node->center);
+    node->radius = vec3_length(vec3_sub(high, low)) / 2;
+    ltree_node_cone(node, lights, &slots[start], end - start);
+    node->cos_reach = cos(node->spread + LTREE_MARGIN);
+    node->sin_reach = sin(node->spread + LTREE_MARGIN);
+    if (end - start == 1)
+    {
+        node->light = slots[start];
+        node->right = -1;
+        return index;
+    }
+    int axis = X;
+    for (int i = Y; i < XYZ; i++)
+    {
+        if (node->box.max[i] - node->box.min[i] >
+            node->box.max[axis] - node->box.min[axis])
+        {
+            axis = i;
+        }
+    }
+    real_t split = (node->box.min[axis] + node->box.max[axis]) / 2;
+    int mid = start;
+    if (depth < LTREE_MAX_DEPTH)
+    {
+        for (int i = start; i < end; i++)
+        {
+            light_t* light = (light_t*)lights->objs[slots[i]].priv;
+            if (light->location[axis] < split)
+            {
+                int temp = slots[i];
+                slots[i] = slots[mid];
+                slots[mid] = temp;
+                mid++;
+            }
+        }
+    }
+    if (mid == start || mid == end)
+    {
+        mid = start + (end - start) / 2;
+    }
+    ltree_build_node(tree, lights, slots, start, mid, depth + 1);
+    int right = ltree_build_node(tree, lights, slots, mid, end, depth + 1);
+    /* Node pointer may not be trusted across the recursive calls. */
+    node = &tree->nodes[index];
+    node->light = -1;
+    node->right = right;
+    return index;
+}
+
+/*
+ * Builds a light tree over every light in a finished store.
+ *
+ * Param: lights  The store of lights.
+ *
+ * Return: The constructed tree.
+ */
+ltree_t* ltree_build(store_t* lights)
+{
+    ltree_t* tree = Malloc(sizeof(ltree_t));
+    int count = lights->count;
+    /* A binary tree with a light in every leaf has one less cluster. */
+    tree->nodes = Malloc(sizeof(ltree_node_t) * (size_t)(2 * count + 1));
+    tree->num_nodes = 0;
+    if (count > 0)
+    {
+        int* slots = Malloc(sizeof(int) * (size_t)count);
+        for (int i = 0; i < count; i++)
+        {
+            slots[i] = i;
+        }
+        ltree_build_node(tree, lights, slots, 0, count, 0);
+        free(slots);
+    }
+    return tree;
+}
+
+/*
+ * Estimates how much light a node could send to a point. For a single light
+ * this is the share process_light would add before shadows, and it is zero
+ * exactly where process_light adds nothing. For a cluster it is a bound made
+ * from the most any corner of its box is turned towards the point, and it is
+ * zero only if the point faces away from the whole box or lies outside the
+ * cluster's cone, so never while some light below could reach the point.
+ *
+ * Param: lights  The store of lights.
+ * Param: node    The node to estimate.
+ * Param: point   The point being shaded.
+ * Param: normal  The unit normal at the point.
+ *
+ * Return: The weight of the node, or 0 if it can't light the point.
+ */
+static real_t ltree_importance(store_t* lights, ltree_node_t* node,
+                               real_t* point, real_t* normal)
+{
+    vec3_t base = vec3_load(point);
+    vec3_t facing = vec3_load(normal);
+    if (node->light >= 0)
+    {
+        obj_t* lobj = &lights->objs[node->light];
+        light_t* light = (light_t*)lobj->priv;
+        vec3_t to_light = vec3_sub(vec3_load(light->location), base);
+        real_t dist = vec3_length(to_light);
+        vec3_t unit_to_light = vec3_unit(to_light);
+        real_t theta = vec3_dot(unit_to_light, facing);
+        if (theta <= 0)
+        {
+            return 0;
+        }
+        if (light->illum_check)
+        {
+            real_t to_hit[DIMENSIONS];
+            vec3_store(vec3_scale(unit_to_light, -1), to_hit);
+            if (!light->illum_check(lobj, to_hit))
+            {
+                return 0;
+            }
+        }
+        return node->power * theta / dist;
+    }
+    vec3_t to_center = vec3_sub(vec3_load(node->center), base);
+    real_t dist = vec3_length(to_center);
+    if (dist <= node->radius)
+    {
+        /* Points within the cluster are kept from counting as infinitely
+         * close by measuring no nearer than the edge of its sphere. */
+        return node->radius > 0 ? node->power / node->radius : node->power;
+    }
+    /* Every light below is within the angle u of the center, seen from the
+     * point, and the tests below widen each cone by u through its sine and
+     * cosine rather than by taking angles. */
+    vec3_t unit_to_center = vec3_scale(to_center, 1 / dist);
+    real_t sin_u = node->radius / dist;
+    real_t cos_u = sqrt(1 - sin_u * sin_u);
+    if (node->spread < (real_t)M_PI &&
+        (node->spread < (real_t)M_PI_2 || sin_u < node->sin_reach))
+    {
+        /* Shuts out points outside the cone the lights shine into. */
+        real_t cos_axis = -vec3_dot(unit_to_center, vec3_load(node->axis));
+        if (cos_axis < node->cos_reach * cos_u - node->sin_reach * sin_u)
+        {
+            return 0;
+        }
+    }
+    real_t cos_facing = vec3_dot(unit_to_center, facing);
+    real_t cosine = 1;
+    if (cos_facing < cos_u)
+    {
+        real_t sin_sq = 1 - cos_facing * cos_facing;
+        real_t sin_facing = sin_sq > 0 ? sqrt(sin_sq) : 0;
+        cosine = cos_facing * cos_u + sin_facing * sin_u;
+        if (cosine + LTREE_MARGIN <= 0)
+        {
+            return 0;
+        }
+        cosine = cosine < LTREE_MARGIN ? LTREE_MARGIN : cosine;
+    }
+    return node->power * cosine / dist;
+}
+
+/*
+ * Picks a light for a point by walking down the tree, taking each branch
+ * with a chance proportional to its importance.
+ *
+ * Param: tree    The tree to walk.
+ * Param: lights  The store of lights the tree was built over.
+ * Param: point   The point being shaded.
+ * Param: normal  The unit normal at the point.
+ * Param: rng     The generator the branches are drawn from.
+ * Param: pdf     Output for the chance that this light was picked.
+ *
+ * Return: The slot of the light picked, or -1 if no light can reach the
+ *         point down the branches taken.
+ */
+int ltree_sample(ltree_t* tree, store_t* lights, real_t* point,
+                 real_t* normal, rng_t* rng, real_t* pdf)
+{
+    *pdf = 1;
+    if (tree->num_nodes == 0)
+    {
+        return -1;
+    }
+    int index = 0;
+    ltree_node_t* node = &tree->nodes[index];
+    if (node->light >= 0)
+    {
+        return ltree_importance(lights, node, point, normal) > 0 ?
+               node->light : -1;
+    }
+    while (node->light < 0)
+    {
+        int left = index + 1;
+        real_t left_weight = ltree_importance(lights, &tree->nodes[left],
+                                              point, normal);
+        real_t right_weight = ltree_importance(lights,
+                                               &tree->nodes[node->right],
+                                               point, normal);
+        real_t total = left_weight + right_weight;
+        if (total <= 0)
+        {
+            return -1;
+        }
+        real_t chance = left_weight / total;
+        if ((real_t)rng_uniform(rng) < chance)
+        {
+            index = left;
+            *pdf *= chance;
+        }
+        else
+        {
+            index = node->right;
+            *pdf *= right_weight / total;
+        }
+        node = &tree->nodes[index];
+    }
+    return node->light;
+}
+
+/*
+ * Frees a light tree.
+ *
+ * Param: tree  The tree to free, which may be NULL.
+ */
+void ltree_free(ltree_t* tree)
+{
+    if (!tree)
+    {
+        return;
+    }
+    free(tree->nodes);
+    free(tree);
+}
@@ -0,0 +1,83 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This is the header file for the lighttree.c source file. It contains a
+ * binary tree over the lights of a scene, which is used to pick a light at
+ * random for a point being shaded, with each light as likely to be picked
+ * as its share of the light that could reach the point.
+ */
+
+/* Ensures this header file is only included once. */
+#pragma once
+
+/* Includes the store_t struct that the tree is built over. */
+#include "store.h"
+/* Includes the light_t struct that the tree reads locations from. */
+#include "light.h"
+/* Includes the spotlight_t struct that the tree reads cones from. */
+#include "spotlight.h"
+/* Includes the bbox_t struct that bounds each cluster of lights. */
+#include "bbox.h"
+/* Includes rng_t for drawing the branches taken. */
+#include "rng.h"
+
+/* The depth past which clusters are split in half rather than in space, so
+ * that lights bunched into a corner can't build a very deep tree. */
+#define LTREE_MAX_DEPTH 32
+
+/* The angle, in radians, that a cluster's cone is widened by when checked
+ * against a point, so that rounding can't shut out a light that reaches it. */
+#define LTREE_MARGIN 1e-4
+
+/*
+ * One node of a light tree. A node is either a single light or a cluster
+ * made of the two nodes that follow from it.
+ *
+ * Data Member: box    The bounds of the locations of the lights below.
+ * Data Member: center The center of box.
+ * Data Member: radius The radius of the sphere around box.
+ * Data Member: power  The summed emissivity of the lights below.
+ * Data Member: axis   The unit centerline of a cone around every direction
+ *                     the lights below shine in.
+ * Data Member: spread The half-width of that cone in radians, which is pi
+ *                     if some light below shines every way.
+ * Data Member: cos_reach  The cosine of spread widened by LTREE_MARGIN.
+ * Data Member: sin_reach  The sine of spread widened by LTREE_MARGIN.
+ * Data Member: right  The second child of a cluster. The first child comes
+ *                     straight after the cluster.
+ * Data Member: light  The slot of the light in the model's lights, or -1
+ *                     for clusters.
+ */
+typedef struct ltree_node_type
+{
+    bbox_t box;
+    real_t center[XYZ];
+    real_t radius;
+    real_t power;
+    real_t axis[XYZ];
+    real_t spread;
+    real_t cos_reach;
+    real_t sin_reach;
+    int right;
+    int light;
+} ltree_node_t;
+
+/*
+ * A light tree.
+ *
+ * Data Member: nodes  The flattened tree, with the root first.
+ * Data Member: num_nodes  The number of nodes in use.
+ */
+typedef struct ltree_type
+{
+    ltree_node_t* nodes;
+    int num_nodes;
+} ltree_t;
+
+ltree_t* ltree_build(store_t* lights);
+
+int ltree_sample(ltree_t* tree, store_t* lights, real_t* point,
+                 real_t* normal, rng_t* rng, real_t* pdf);
+
+void ltree_free(ltree_t* tree);
@@ -20,6 +20,152 @@ int main(int argc, char **argv)
     /* Tracks if this file has completed operations succesfully. */
     int rc;
 
+    /* Set when the scene should be scanned linearly instead of through the
+     * bounding volume hierarchy. */
+    int linear = FALSE;
+
+    /* The number of threads to render with. Zero asks for one per CPU. */
+    int threads = 1;
+
+    /* The seed for anti-aliasing samples. */
+    uint32_t seed = 0;
+
+    /* The initial and largest number of anti-aliasing samples per pixel. A
+     * largest count of 0 means AA_MAX_FACTOR times the initial count. */
+    int aa_initial = AA_INITIAL;
+    int aa_max = 0;
+
+    /* Where the statistics report goes, "-" for stderr, or NULL for none. */
+    char* stats_file = NULL;
+
+    /* The instruction set the vector kernels run with. */
+    int isa = cpu_best_isa();
+
+    /* The caps on following reflective bounces. */
+    int max_depth = MAX_DEPTH;
+    real_t min_throughput = MIN_THROUGHPUT;
+    real_t max_dist = MAX_DIST;
+
+    /* The lights drawn for each hit, or 0 to add up every light. */
+    int light_samples = 0;
+
+    /* Reads the optional flags that come before the window size. */
+    int opt;
+    while ((opt = getopt(argc, argv, OPTSTRING)) != -1)
+    {
+        switch (opt)
+        {
+            case 'l':
+                linear = TRUE;
+                break;
+            case 't':
+                errno = 0;
+                threads = (int)strtol(optarg, NULL, DECIMAL);
+                if (errno || threads < 0)
+                {
+                    fprintf(stderr, "Thread count must be a non-negative "
+                                    "integer.\n");
+                    usage(argv[0]);
+                }
+                if (threads == 0)
+                {
+                    threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+                }
+                break;
+            case 's':
+                errno = 0;
+                seed = (uint32_t)strtoul(optarg, NULL, DECIMAL);
+                if (errno)
+                {
+                    fprintf(stderr, "Seed must be an unsigned integer.\n");
+                    usage(argv[0]);
+                }
+                break;
+            case 'S':
+                stats_file = optarg;
+                stats_enabled = TRUE;
+                break;
+            case 'V':
+                isa = cpu_parse_isa(optarg);
+                if (isa == ISA_UNKNOWN)
+                {
+                    fprintf(stderr, "Unknown instruction set %s.\n", optarg);
+                    usage(argv[0]);
+                }
+                if (!cpu_supports(isa))
+                {
+                    fprintf(stderr, "This processor does not support %s.\n",
+                            optarg);
+                    usage(argv[0]);
+                }
+                break;
+            case 'a':
+            case 'A':
+                errno = 0;
+                int samples = (int)strtol(optarg, NULL, DECIMAL);
+                if (errno || samples < 0)
+                {
+                    fprintf(stderr, "Sample counts must be non-negative "
+                                    "integers.\n");
+                    usage(argv[0]);
+                }
+                if (opt == 'a')
+                {
+                    aa_initial = samples;
+                }
+                else
+                {
+                    aa_max = samples;
+                }
+                break;
+            case 'd':
+                errno = 0;
+                max_depth = (int)strtol(optarg, NULL, DECIMAL);
+                if (errno || max_depth < 0 || max_depth > MAX_DEPTH)
+                {
+                    fprintf(stderr, "Depth must be an integer from 0 to "
+                                    "%d.\n", MAX_DEPTH);
+                    usage(argv[0]);
+                }
+                break;
+            case 'c':
+            case 'm':
+                errno = 0;
+                real_t limit = (real_t)strtod(optarg, NULL);
+                if (errno || limit < 0)
+                {
+                    fprintf(stderr, "Throughput and distance limits must be "
+                                    "non-negative numbers.\n");
+                    usage(argv[0]);
+                }
+                if (opt == 'c')
+                {
+                    min_throughput = limit;
+                }
+                else
+                {
+                    max_dist = limit;
+                }
+                break;
+            case 'L':
+                errno = 0;
+                light_samples = (int)strtol(optarg, NULL, DECIMAL);
+                if (errno || light_samples < 0)
+                {
+                    fprintf(stderr, "Light samples must be a non-negative "
+                                    "integer.\n");
+                    usage(argv[0]);
+                }
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+    /* Shifts the remaining arguments down so they are read as before. */
+    argv[optind - 1] = argv[0];
+    argc -= optind - 1;
+    argv += optind - 1;
+
     /* This section does argument checking. This has been moved out of 
      * projection_init, where it was originally located in the class notes. */
     if(argc != CORRECT_ARGS)
@@ -57,21 +203,66 @@ int main(int argc, char **argv)
                         "zero");
         usage(argv[0]);
     }
+    /* Picks the kernels before the hierarchy is sized for them. */
+    sbatch_select(isa);
+    /* Opens the scene, which is mapped if it is a binary scene. */
+    double start = stats_clock();
+    scene_in_t* in = scene_open(stdin, FALSE);
+    if (!in)
+    {
+        free(model);
+        return FAILURE;
+    }
     /* Sets up the initial projection. */
-    model->proj = projection_init(x, y, stdin);
+    model->proj = projection_init(x, y, in);
     /* Dumps the projection info just read in to stderr for debugging. */
     projection_dump(stderr, model->proj);
-    /* Initializes the linked list for the lights and scene object. */
-    model->lights = list_init();
-    model->scene = list_init();
+    /* Initializes the stores for the lights and scene objects. */
+    model->lights = store_init();
+    model->scene = store_init();
+    model->bvh = NULL;
+    model->threads = threads;
+    model->seed = seed;
+    model->aa_initial = aa_initial;
+    if (aa_max == 0)
+    {
+        aa_max = aa_initial * AA_MAX_FACTOR;
+    }
+    model->aa_max = aa_max > aa_initial ? aa_max : aa_initial;
+    model->max_depth = max_depth;
+    model->min_throughput = min_throughput;
+    model->max_dist = max_dist;
+    model->light_lists = NULL;
+    model->light_samples = light_samples;
+    model->light_tree = NULL;
     /* Initializes the model's values, and stores a return rc value. */
-    rc = model_init(stdin, model);
+    rc = model_init(in, model);
+    scene_close(in);
+    stats_phase(PHASE_LOAD, start);
     /* Dumps full model for debugging purposes. */
     model_dump(stderr, model);
 
     /* If no problems so far, make the image. */
     if (rc == SUCCESS)
     {
+        /* Finds the lights that can reach each object. */
+        start = stats_clock();
+        build_light_lists(model);
+        stats_phase(PHASE_BUILD, start);
+        /* Builds the tree lights are drawn from, if they are sampled. */
+        if (light_samples > 0)
+        {
+            start = stats_clock();
+            model->light_tree = ltree_build(model->lights);
+            stats_phase(PHASE_BUILD, start);
+        }
+        /* Builds the hierarchy once, now that the scene is complete. */
+        if (!linear)
+        {
+            start = stats_clock();
+            model->bvh = bvh_build(model->scene);
+            stats_phase(PHASE_BUILD, start);
+        }
         make_image(model);
         /*fprintf(stderr, "Post-image print:\n\n");
         projection_dump(stderr, model->proj);
@@ -84,14 +275,23 @@ int main(int argc, char **argv)
                         "produced.");
     }
     /* Frees the model */
+    start = stats_clock();
     free(model->proj);
+    bvh_free(model->bvh);
+    free(model->light_lists);
+    ltree_free(model->light_tree);
     fprintf(stderr, "\nNow deleting lights...");
-    /* Recursively deletes the lights list. */
-    delete_list(model->lights);
+    /* Deletes the lights store. */
+    delete_store(model->lights);
     fprintf(stderr, "Lights deleted succesfully.\nNow deleting scene...");
-    /* Recursively deletes the scene list. */
-    delete_list(model->scene);
+    /* Deletes the scene store. */
+    delete_store(model->scene);
     fprintf(stderr, "Scene deleted succesfully.\n");
+    stats_phase(PHASE_CLEANUP, start);
+    if (stats_file)
+    {
+        write_stats(stats_file, x, y, threads, isa);
+    }
     /* Finally frees the model. */
     free(model);
     fprintf(stderr, "Cleanup complete.\n");
@@ -99,6 +299,34 @@ int main(int argc, char **argv)
     return(rc);
 }
 
+/*
+ * Writes the statistics report to a file, or to stderr for "-".
+ *
+ * Param: filename  The file to write, or "-" for stderr.
+ * Param: width     The image width in pixels.
+ * Param: height    The image height in pixels.
+ * Param: threads   The number of threads rendered with.
+ * Param: isa       The instruction set the vector kernels ran with.
+ */
+void write_stats(char* filename, int width, int height, int threads,
+                 int isa)
+{
+    if (!strcmp(filename, "-"))
+    {
+        stats_report(stderr, width, height, threads, cpu_isa_name(isa));
+        return;
+    }
+    FILE* out = fopen(filename, "w");
+    if (NULL == out)
+    {
+        fprintf(stderr, "Unable to open %s for the statistics report.\n",
+                filename);
+        return;
+    }
+    stats_report(out, width, height, threads, cpu_isa_name(isa));
+    fclose(out);
+}
+
 /*
  * A function for printing the proper usage of this program and exiting with
  * failure in the event that command line arguments are incorrect. Proper 
@@ -110,8 +338,38 @@ int main(int argc, char **argv)
  */
 void usage(char* filename)
 {
-    fprintf(stderr, "Usage: %s <x world coordinate> <y world coordinate>"
-                    "<output file name>",
-            filename);
+    fprintf(stderr, "Usage: %s [-l] [-t threads] [-s seed] [-a samples] "
+                    "[-A samples] [-S file] [-V isa] [-d depth] "
+                    "[-c throughput] [-m distance] [-L lights] "
+                    "<x world coordinate> <y world coordinate> "
+                    "<output file name>\n"
+                    "  The scene is read from stdin, either as text or as a "
+                    "binary scene written\n  by scenec, which must be "
+                    "redirected from a file.\n"
+                    "  -l  Scan every object instead of using the bounding "
+                    "volume hierarchy.\n"
+                    "  -t  Render on this many threads, or one per CPU for "
+                    "0. Defaults to 1.\n"
+                    "  -s  Seed for anti-aliasing samples. Defaults to 0.\n"
+                    "  -a  Initial anti-aliasing samples per pixel. Defaults "
+                    "to 0, which turns anti-aliasing off.\n"
+                    "  -A  Most anti-aliasing samples for pixels on edges or "
+                    "with noisy color. Defaults to 4 times -a.\n"
+                    "  -S  Write statistics as JSON to this file, or to "
+                    "stderr for -.\n"
+                    "  -V  Run the vector kernels with scalar, sse2, avx2 or "
+                    "avx512. Defaults\n      to the best this processor "
+                    "supports.\n"
+                    "  -d  Most reflective bounces to follow, up to %d. "
+                    "Defaults to %d.\n"
+                    "  -c  Stop following bounces once the product of the "
+                    "specular reflectances\n      falls below this. Defaults "
+                    "to 0.\n"
+                    "  -m  Stop following bounces past this total distance, "
+                    "or never for 0.\n      Defaults to %g.\n"
+                    "  -L  Light each hit with this many lights drawn at "
+                    "random, favoring those\n      that shine on it most, "
+                    "or with every light for 0. Defaults to 0.\n",
+            filename, MAX_DEPTH, MAX_DEPTH, (double)MAX_DIST);
     exit(EXIT_FAILURE);
 }
@@ -27,6 +27,15 @@
  */
 #include <errno.h>
 
+/* Included for getopt, used to read the optional command line flags. */
+#include <unistd.h>
+
+/* Included for strcmp, used to check for the stderr statistics file. */
+#include <string.h>
+
+/* Includes the instruction set checks behind the -V flag. */
+#include "cpu.h"
+
 /* Representing base 10 in the strtol function. */
 #define DECIMAL 10
 
@@ -34,5 +43,11 @@
  */
 #define CORRECT_ARGS 3
 
+/* The optional flags understood by this program, in getopt form. */
+#define OPTSTRING "lt:s:a:A:S:V:d:c:m:L:"
+
 
 void usage(char* filename);
+
+void write_stats(char* filename, int width, int height, int threads,
+                 int isa);
@@ -18,26 +18,19 @@
 
 #include "material.h"
 
-int material_load(FILE* in, material_t* material)
+/* Included for finding the unit normal of a hit. */
+#include "vec3.h"
+
+int material_load(scene_in_t* in, material_t* material)
 {
      int pcount = 0;
      int rc = SUCCESS;
-     char buff[BUFF_SIZE];
-     pcount += fscanf(in, "%lf %lf %lf", 
-                      &(material->ambient[R]), 
-                      &(material->ambient[G]),
-                      &(material->ambient[B]));
-     fgets(buff, BUFF_SIZE, in);
-     pcount += fscanf(in, "%lf %lf %lf",
-                      &(material->diffuse[R]),
-                      &(material->diffuse[G]),
-                      &(material->diffuse[B]));
-    fgets(buff, BUFF_SIZE, in);
-    pcount += fscanf(in, "%lf %lf %lf",
-                     &(material->specular[R]),
-                     &(material->specular[G]),
-                     &(material->specular[B]));
-    fgets(buff, BUFF_SIZE, in);
+     pcount += scene_read(in, 3, &(material->ambient[R]),
+                          &(material->ambient[G]), &(material->ambient[B]));
+     pcount += scene_read(in, 3, &(material->diffuse[R]),
+                          &(material->diffuse[G]), &(material->diffuse[B]));
+    pcount += scene_read(in, 3, &(material->specular[R]),
+                         &(material->specular[G]), &(material->specular[B]));
     if (pcount != MATERIAL_OBJS)
     {
         rc = FAILURE;
@@ -50,13 +43,15 @@ int material_load(FILE* in, material_t* material)
  * specified.
  *
  * Param: obj  The object to take RGB ambient values from.
+ * Param: hit  The hit being lit, which the default plugins do not need.
  * Param: output  The output array to store the RGB values in.
  */
-void default_getamb(obj_t* obj, double* output)
+void default_getamb(obj_t* obj, hit_t* hit, real_t* output)
 {
-    output[R] = obj->material.ambient[R];
-    output[G] = obj->material.ambient[G];
-    output[B] = obj->material.ambient[B];
+    (void)hit;
+    output[R] = obj->cold->material.ambient[R];
+    output[G] = obj->cold->material.ambient[G];
+    output[B] = obj->cold->material.ambient[B];
 }
 
 /*
@@ -64,13 +59,15 @@ void default_getamb(obj_t* obj, double* output)
  * specified.
  *
  * Param: obj  The object to take RGB ambient values from.
+ * Param: hit  The hit being lit, which the default plugins do not need.
  * Param: output  The output array to store the RGB values in.
  */
-void default_getdiff(obj_t* obj, double* output)
+void default_getdiff(obj_t* obj, hit_t* hit, real_t* output)
 {
-    output[R] = obj->material.diffuse[R];
-    output[G] = obj->material.diffuse[G];
-    output[B] = obj->material.diffuse[B];
+    (void)hit;
+    output[R] = obj->cold->material.diffuse[R];
+    output[G] = obj->cold->material.diffuse[G];
+    output[B] = obj->cold->material.diffuse[B];
 }
 
 /*
@@ -78,13 +75,31 @@ void default_getdiff(obj_t* obj, double* output)
  * specified.
  *
  * Param: obj  The object to take RGB ambient values from.
+ * Param: hit  The hit being lit, which the default plugins do not need.
  * Param: output  The output array to store the RGB values in.
  */
-void default_getspec(obj_t* obj, double* output)
+void default_getspec(obj_t* obj, hit_t* hit, real_t* output)
+{
+    (void)hit;
+    output[R] = obj->cold->material.specular[R];
+    output[G] = obj->cold->material.specular[G];
+    output[B] = obj->cold->material.specular[B];
+}
+
+/*
+ * This function fills in the shading record for a hit by running each of the
+ * object's material plugins once, and finds the unit normal.
+ *
+ * Param: obj  The object that was hit.
+ * Param: hit  The hit being shaded.
+ * Param: shade  The output shading record.
+ */
+void default_shade(obj_t* obj, hit_t* hit, shade_t* shade)
 {
-    output[R] = obj->material.specular[R];
-    output[G] = obj->material.specular[G];
-    output[B] = obj->material.specular[B];
+    obj->cold->getamb(obj, hit, shade->ambient);
+    obj->cold->getdiff(obj, hit, shade->diffuse);
+    obj->cold->getspec(obj, hit, shade->specular);
+    vec3_store(vec3_unit(vec3_load(hit->normal)), shade->normal);
 }
 
 /*
@@ -97,9 +112,9 @@ void print_materials(FILE* out, material_t material)
              "Ambient  - %lf %lf %lf\n"
              "Diffuse  - %lf %lf %lf\n"
              "Specular - %lf %lf %lf\n",
-             material.ambient[R],
-             material.ambient[G], material.ambient[B],
-             material.diffuse[R], material.diffuse[G],
-             material.diffuse[B], material.specular[R],
-             material.specular[G], material.specular[B]);
+             (double)material.ambient[R],
+             (double)material.ambient[G], (double)material.ambient[B],
+             (double)material.diffuse[R], (double)material.diffuse[G],
+             (double)material.diffuse[B], (double)material.specular[R],
+             (double)material.specular[G], (double)material.specular[B]);
 }
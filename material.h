@@ -10,6 +10,12 @@
 #pragma once
 #define RGB_SIZE 3
 
+/* Includes the real_t type. */
+#include "utils.h"
+
+/* Includes the scene reader that materials are read through. */
+#include "scenefile.h"
+
 /* Forward declarion of the material_t type. */
 typedef struct material_type material_t;
 
@@ -26,20 +32,41 @@ typedef struct material_type material_t;
  */
 struct material_type
 {
-    double ambient [RGB_SIZE];
-    double diffuse [RGB_SIZE];
-    double specular [RGB_SIZE];
+    real_t ambient [RGB_SIZE];
+    real_t diffuse [RGB_SIZE];
+    real_t specular [RGB_SIZE];
 };
 
 /* Included for the obj_t typedef for material_load. */
 #include "object.h"
 
-int material_load(FILE* in, material_t* material);
+/*
+ * The structure that holds everything the lighting needs to know about the
+ * surface at one hit. It is filled in once per hit, so that the material
+ * plugins and the normal are not worked out again for every light.
+ *
+ * Data Member: ambient  The RGB ambient light at the hit, after any
+ *                       procedural coloring.
+ * Data Member: diffuse  The RGB diffuse reflectivity at the hit.
+ * Data Member: specular The RGB specular reflectivity at the hit.
+ * Data Member: normal   The unit normal at the hit.
+ */
+struct shade_type
+{
+    real_t ambient [RGB_SIZE];
+    real_t diffuse [RGB_SIZE];
+    real_t specular [RGB_SIZE];
+    real_t normal [DIMENSIONS];
+};
+
+int material_load(scene_in_t* in, material_t* material);
+
+void default_getamb(obj_t* obj, hit_t* hit, real_t* output);
 
-void default_getamb(obj_t* obj, double* output);
+void default_getdiff(obj_t* obj, hit_t* hit, real_t* output);
 
-void default_getdiff(obj_t* obj, double* output);
+void default_getspec(obj_t* obj, hit_t* hit, real_t* output);
 
-void default_getspec(obj_t* obj, double* output);
+void default_shade(obj_t* obj, hit_t* hit, shade_t* shade);
 
 void print_materials(FILE* out, material_t material);
@@ -17,10 +17,10 @@
  * Param: mat2  The right matrix to multiply.
  * Param: mat3  The output matrix.
  */
-void matrix_mult(double mat1[XYZ][XYZ], double mat2[XYZ][XYZ],
-                 double mat3[XYZ][XYZ])
+void matrix_mult(real_t mat1[XYZ][XYZ], real_t mat2[XYZ][XYZ],
+                 real_t mat3[XYZ][XYZ])
 {
-    double temp[XYZ][XYZ];
+    real_t temp[XYZ][XYZ];
     for (int i = 0; i < XYZ; i++)
     {
         for (int j = 0; j < XYZ; j++)
@@ -49,9 +49,9 @@ void matrix_mult(double mat1[XYZ][XYZ], double mat2[XYZ][XYZ],
  * Param: vec1  The vector to multiply
  * Parm: output The output vector
  */
-void matrix_vec(double mat1[XYZ][XYZ], double vec1[XYZ], double output[XYZ])
+void matrix_vec(real_t mat1[XYZ][XYZ], real_t vec1[XYZ], real_t output[XYZ])
 {
-    double temp[XYZ];
+    real_t temp[XYZ];
     for (int i = 0; i < XYZ; i++)
     {
         temp[i] = dot3(mat1[i], vec1);
@@ -66,7 +66,7 @@ void matrix_vec(double mat1[XYZ][XYZ], double vec1[XYZ], double output[XYZ])
  * This is a function to transpose a matrix.
  * Param: mat1  The matrix to transpose.
  */
-void transpose_mat(double mat1[XYZ][XYZ], double mat2[XYZ][XYZ])
+void transpose_mat(real_t mat1[XYZ][XYZ], real_t mat2[XYZ][XYZ])
 {
     for (int i = 0; i < XYZ; i++)
     {
@@ -76,7 +76,7 @@ void transpose_mat(double mat1[XYZ][XYZ], double mat2[XYZ][XYZ])
     {
         for (int j = 0; j < i; j++)
         {
-            double temp = mat1[i][j];
+            real_t temp = mat1[i][j];
             mat2[i][j] = mat1[j][i];
             mat2[j][i] = temp;
         }
@@ -90,9 +90,9 @@ void transpose_mat(double mat1[XYZ][XYZ], double mat2[XYZ][XYZ])
  * Param: W The second matrix to multiply.
  * Param: output  The output matrix to store the cross product in.
  */
-void cross_prod(double V[XYZ], double W[XYZ], double output[XYZ])
+void cross_prod(real_t V[XYZ], real_t W[XYZ], real_t output[XYZ])
 {
-    double temp[XYZ];
+    real_t temp[XYZ];
     temp[X] = (V[Y] * W[Z] - V[Z] * W[Y]);
     temp[Y] = (V[Z] * W[X] - V[X] * W[Z]);
     temp[Z] = (V[X] * W[Y] - V[Y] * W[X]);
@@ -109,9 +109,9 @@ void cross_prod(double V[XYZ], double W[XYZ], double output[XYZ])
  * Param: N The vector to that will have V project onto it.
  * Param: P The output vector for this process.
  */
-void projection(double V[XYZ], double N[XYZ], double P[XYZ])
+void projection(real_t V[XYZ], real_t N[XYZ], real_t P[XYZ])
 {
-    double scaled_n[XYZ];
+    real_t scaled_n[XYZ];
     scale3(dot3(V, N), N, scaled_n);
     diff3(scaled_n, V, P);
 }
@@ -121,9 +121,9 @@ void projection(double V[XYZ], double N[XYZ], double P[XYZ])
  * function.
  * Param: The matrix to output into.
  */
-void get_id_matrix(double output[XYZ][XYZ])
+void get_id_matrix(real_t output[XYZ][XYZ])
 {
-    static double id_matrix[XYZ][XYZ] = 
+    static real_t id_matrix[XYZ][XYZ] = 
     {
         {1, 0, 0}, 
         {0, 1, 0}, 
@@ -139,21 +139,9 @@ void get_id_matrix(double output[XYZ][XYZ])
  * Param: vec1  The vector to transform with.
  * Param: vec2  The output vector.
  */
-void transform(double mat1[XYZ][XYZ], double vec1[XYZ], double vec2[XYZ])
+void transform(real_t mat1[XYZ][XYZ], real_t vec1[XYZ], real_t vec2[XYZ])
 {
-    double temp[XYZ];
-    for (int i = 0; i < XYZ; i++)
-    {
-        temp[i] = 0;
-        for (int j = 0; j < XYZ; j++)
-        {
-            temp[i] += mat1[i][j] * vec1[j];
-        }
-    }
-    for(int i = 0; i < XYZ; i++)
-    {
-        vec2[i] = temp[i];
-    }
+    vec3_store(vec3_xform(mat1, vec3_load(vec1)), vec2);
 }
 
 /*
@@ -161,7 +149,7 @@ void transform(double mat1[XYZ][XYZ], double vec1[XYZ], double vec2[XYZ])
  * Param: label  The label to print representing the matrix.
  * Param: mat    The matrix to print.
  */
-void matrix_print(char* label, double mat[XYZ][XYZ])
+void matrix_print(char* label, real_t mat[XYZ][XYZ])
 {
     fprintf(stderr, "%s\n", label);
     for (int i = 0; i < XYZ; i++)
@@ -179,7 +167,7 @@ void matrix_print(char* label, double mat[XYZ][XYZ])
  * Param: mat1  The matrix to be copied.
  * Param: mat2  The matrix to copy to.
  */
-void copy_matrix(double mat1[XYZ][XYZ], double mat2[XYZ][XYZ])
+void copy_matrix(real_t mat1[XYZ][XYZ], real_t mat2[XYZ][XYZ])
 {
     for (int i = 0; i < XYZ; i++)
     {
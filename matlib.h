@@ -16,21 +16,21 @@
 #define Z 2
 #define XYZ 3
 
-void matrix_mult(double mat1[XYZ][XYZ], double mat2[XYZ][XYZ], 
-                 double mat3[XYZ][XYZ]);
+void matrix_mult(real_t mat1[XYZ][XYZ], real_t mat2[XYZ][XYZ], 
+                 real_t mat3[XYZ][XYZ]);
 
-void matrix_vec(double mat1[XYZ][XYZ], double vec1[XYZ], double output[XYZ]);
+void matrix_vec(real_t mat1[XYZ][XYZ], real_t vec1[XYZ], real_t output[XYZ]);
 
-void transpose_mat(double mat1[XYZ][XYZ], double mat2[XYZ][XYZ]);
+void transpose_mat(real_t mat1[XYZ][XYZ], real_t mat2[XYZ][XYZ]);
 
-void cross_prod(double V[XYZ], double W[XYZ], double output[XYZ]);
+void cross_prod(real_t V[XYZ], real_t W[XYZ], real_t output[XYZ]);
 
-void projection(double V[XYZ], double N[XYZ], double P[XYZ]);
+void projection(real_t V[XYZ], real_t N[XYZ], real_t P[XYZ]);
 
-void get_id_matrix(double output[XYZ][XYZ]);
+void get_id_matrix(real_t output[XYZ][XYZ]);
 
-void matrix_print(char* label, double mat[XYZ][XYZ]);
+void matrix_print(char* label, real_t mat[XYZ][XYZ]);
 
-void copy_matrix(double mat1[XYZ][XYZ], double mat2[XYZ][XYZ]);
+void copy_matrix(real_t mat1[XYZ][XYZ], real_t mat2[XYZ][XYZ]);
 
-void transform(double mat1[XYZ][XYZ], double vec1[XYZ], double vec2[XYZ]);
+void transform(real_t mat1[XYZ][XYZ], real_t vec1[XYZ], real_t vec2[XYZ]);
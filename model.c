@@ -18,9 +18,8 @@
  *
  * Return: rc   If creation of the model was succesful.
  */
-int model_init(FILE* in, model_t* model)
+int model_init(scene_in_t* in, model_t* model)
 {
-    char buff[BUFF_SIZE];
     int* objtype = Malloc(sizeof(int));
     int rc = SUCCESS;
     obj_t* obj = NULL;
@@ -28,10 +27,9 @@ int model_init(FILE* in, model_t* model)
      * This codeblock continues as long as decimal number can continue to be 
      * read from the input source, and as long as rc has not indicated an error.
      */
-    while(fscanf(in, " %d", objtype) != -1 && !rc)
+    while(scene_read_type(in, objtype) && !rc)
     {
         obj= NULL;
-        fgets(buff, BUFF_SIZE, in);
         obj = create_objects(objtype, obj, &rc, in);
         if (obj == NULL)
         {
@@ -41,20 +39,23 @@ int model_init(FILE* in, model_t* model)
         {
             if(*objtype <= LAST_LIGHT)
             {
-                list_add(model->lights, obj);
+                store_add(model->lights, obj);
             }
             else
             {
-                list_add(model->scene, obj);
+                store_add(model->scene, obj);
             }
         }
     }
     free(objtype);
+    /* Groups the objects by type now that none are left to add. */
+    store_finish(model->lights);
+    store_finish(model->scene);
     return rc;
 }
 
 /* Dummy function remove me eventually. */
-obj_t* dummy_init(FILE* in, int objtype)
+obj_t* dummy_init(scene_in_t* in, int objtype)
 {
     fprintf(stderr, "Dummy_init function called.");
     void* junk = 0;
@@ -74,10 +75,10 @@ obj_t* dummy_init(FILE* in, int objtype)
  *
  * Return: obj    The object that we just initialized.
  * */
-obj_t* create_objects(int* objtype, obj_t* obj, int* rc, FILE* in)
+obj_t* create_objects(int* objtype, obj_t* obj, int* rc, scene_in_t* in)
 {
     /* Static list of init_functions. */
-    static obj_t* (*obj_loaders[])(FILE *in, int objtype) =
+    static obj_t* (*obj_loaders[])(scene_in_t* in, int objtype) =
     {
         light_init,
         spotlight_init,
@@ -118,15 +119,15 @@ obj_t* create_objects(int* objtype, obj_t* obj, int* rc, FILE* in)
 void model_dump(FILE* out, model_t* model)
 {
     fprintf(out, "Now dumping lights:\n");
-    if(model->lights->head)
+    for (int i = 0; i < model->lights->count; i++)
     {
-        dump_object(out, model->lights->head);
+        dump_object(out, &model->lights->objs[i]);
     }
     fprintf(out, "End of Light Dump\n\n");
     fprintf(out, "Now dumping scene data:\n");
-    if(model->scene->head)
+    for (int i = 0; i < model->scene->count; i++)
     {
-        dump_object(out, model->scene->head);
+        dump_object(out, &model->scene->objs[i]);
     }
     fprintf(stderr, "End of Scene Dump\n\n");
     fprintf(stderr, "End Data Dump\n");
@@ -166,11 +167,11 @@ void print_object(FILE* out, obj_t* obj)
 }
 
 /* 
- * This is a helper function for model_dump. This function recursively dumps
- * information from a list of objects using print_object.
+ * This is a helper function for model_dump. This function dumps the
+ * information of one object using print_object.
  *
  * Param: out   The stream to output data to.
- * Param: obj   The current object to dump.
+ * Param: obj   The object to dump.
  */
 void dump_object(FILE* out, obj_t* obj)
 {
@@ -194,13 +195,42 @@ void dump_object(FILE* out, obj_t* obj)
     fprintf(out, "\nDumping object of type %s\n", type);
     if(!is_light(obj->objtype))
     {
-        print_materials(out, obj->material);
+        print_materials(out, obj->cold->material);
     }
     print_object(out, obj);
-    if (NULL != obj->next)
+}
+
+/*
+ * This function finds the world space bounds of a scene object, based on
+ * the object type. Planes report themselves as unbounded.
+ *
+ * Param: obj  The object to bound.
+ * Param: box  The output box. Only written for bounded objects.
+ *
+ * Return: BOUNDED if box was set, UNBOUNDED otherwise.
+ */
+int object_bounds(obj_t* obj, bbox_t* box)
+{
+    /* List of object bounds pointers. */
+    static int (*obj_bounders[])(obj_t* obj, bbox_t* box) =
     {
-        dump_object(out, obj->next);
-    }
+        bounds_dummy, //light
+        bounds_dummy, //spotlight
+        bounds_dummy,
+        sphere_bounds,
+        plane_bounds,
+        fplane_bounds, //finite_plane
+        plane_bounds, //tiled_plane, tiles cover the whole plane
+        bounds_dummy, //tex_plane
+        bounds_dummy, //ref_sphere
+        sphere_bounds, //p_sphere
+        plane_bounds, //pplane
+        parab_bounds, //parabaloid
+        cyl_bounds,
+        cone_bounds,
+        hyperb_bounds
+    };
+    return obj_bounders[obj->objtype - FIRST_TYPE](obj, box);
 }
 
 /* 
@@ -215,4 +245,15 @@ void dump_dummy(FILE* out, obj_t* obj)
     fprintf(out, "Object type -> %d\n", obj->objtype);
 }
 
-
+/*
+ * Dummy bounds function, for types that are never placed in the scene.
+ * Param: obj  The object that should have been bounded.
+ * Param: box  The output box, which is not written.
+ * Return: UNBOUNDED.
+ */
+int bounds_dummy(obj_t* obj, bbox_t* box)
+{
+    (void)box;
+    fprintf(stderr, "Dummy bounds called for object type %d.\n", obj->objtype);
+    return UNBOUNDED;
+}
@@ -14,8 +14,8 @@
 #include "light.h"
 /* Necessary for the projection_t structure. */
 #include "projection.h"
-/* Necessary for the list_t structure. */
-#include "linked_list.h"
+/* Necessary for the store_t structure. */
+#include "store.h"
 /* Necessary for the sphere_t structure. */
 #include "sphere.h"
 /* Necessary for the plane_t structure. */
@@ -38,31 +38,69 @@
 #include "cone.h"
 /* Necessary for hyperb_t data structure and functions. */
 #include "hyperboloid.h"
+/* Necessary for the bvh_t structure. */
+#include "bvh.h"
+/* Necessary for the ltree_t structure. */
+#include "lighttree.h"
 
 /* 
  * Structure of a model, representing the image to be drawn. 
  * 
  * Data Member: proj  The projection that stores world information, such as 
  *                    viewpoint, world size, and screen size in pixels.
- * Data Member: lights  A linked list of all lights contained in this model.
- * Data Member: scene   A linked list of all scene objects in this model.
+ * Data Member: lights  A store of all lights contained in this model.
+ * Data Member: scene   A store of all scene objects in this model.
+ * Data Member: bvh     The hierarchy over scene, or NULL to scan the store.
+ * Data Member: threads The number of threads the image is rendered with.
+ * Data Member: seed    The seed that anti-aliasing samples are drawn from.
+ * Data Member: aa_initial The samples taken in every pixel, or 0 for no AA.
+ * Data Member: aa_max  The most samples an anti-aliased pixel may take.
+ * Data Member: max_depth  The most reflective bounces a ray is followed
+ *                         through.
+ * Data Member: min_throughput  The specular throughput, the product of the
+ *                              reflectances along a path, below which
+ *                              bounces stop being followed.
+ * Data Member: max_dist  The distance a ray may travel through its bounces,
+ *                        or 0 for no limit.
+ * Data Member: light_lists  The lists of lights that can reach each scene
+ *                           object, in one array, or NULL if none were
+ *                           needed.
+ * Data Member: light_samples  The lights drawn at random for each hit, or 0
+ *                             to add up every light.
+ * Data Member: light_tree  The tree lights are drawn from, or NULL when
+ *                          every light is added up.
  */
 typedef struct model_type
 {
     proj_t* proj;
-    list_t* lights;
-    list_t* scene;
+    store_t* lights;
+    store_t* scene;
+    bvh_t* bvh;
+    int threads;
+    uint32_t seed;
+    int aa_initial;
+    int aa_max;
+    int max_depth;
+    real_t min_throughput;
+    real_t max_dist;
+    int* light_lists;
+    int light_samples;
+    ltree_t* light_tree;
 } model_t;
 
-int model_init(FILE* in, model_t* model);
+int model_init(scene_in_t* in, model_t* model);
 
 void model_dump(FILE* out, model_t* model);
 
 void dump_object(FILE* out, obj_t* obj);
 
-obj_t* dummy_init(FILE* in, int objtype);
+obj_t* dummy_init(scene_in_t* in, int objtype);
 
-obj_t* create_objects(int* objtype, obj_t* obj, int* rc, FILE* in);
+obj_t* create_objects(int* objtype, obj_t* obj, int* rc, scene_in_t* in);
 
 void dump_dummy(FILE* out, obj_t* obj);
 
+int object_bounds(obj_t* obj, bbox_t* box);
+
+int bounds_dummy(obj_t* obj, bbox_t* box);
+
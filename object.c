@@ -2,8 +2,8 @@
  * Author: Tyler Allen
  * Date: 03/11/2013
  * 
- * Source file representing an object. Objects are also the nodes in the 
- * list_t structure.
+ * Source file representing an object. Objects are also the records in the 
+ * store_t structure.
  */
 
 /* Header file for this source file. */
@@ -19,20 +19,22 @@
  *
  * Return: obj  The object that has just been created and initialized.
  */
-obj_t* object_init (FILE *in, int objtype)
+obj_t* object_init (scene_in_t* in, int objtype)
 {
     /* Static counter of how many objects have been created. */
     static int objid = OBJID_INIT;
     obj_t* obj = Malloc(sizeof(obj_t));
-    obj->next = NULL;
+    obj_cold_t* cold = Malloc(sizeof(obj_cold_t));
     obj->objtype = objtype;
     obj->objid = objid;
     objid++; /*increments objid by 1.*/
     obj->priv = NULL;
-    set_nan(obj);
+    obj->cold = cold;
+    cold->lights = NULL;
+    cold->num_lights = 0;
     if (!is_light(objtype))
     {
-        int rc = material_load(in, &obj->material);
+        int rc = material_load(in, &cold->material);
         if (rc != SUCCESS)
         {
             fprintf(stderr, "Error found in obj_init...");
@@ -41,31 +43,24 @@ obj_t* object_init (FILE *in, int objtype)
         }
         else
         {
-            obj->getamb = default_getamb;
-            obj->getdiff = default_getdiff;
-            obj->getspec = default_getspec;
+            cold->getamb = default_getamb;
+            cold->getdiff = default_getdiff;
+            cold->getspec = default_getspec;
+            cold->shade = default_shade;
         }
     }
     else
     {
         obj->hits = NULL;
-        obj->getamb = NULL;
-        obj->getdiff = NULL;
-        obj->getspec = NULL;
+        cold->surface = NULL;
+        cold->getamb = NULL;
+        cold->getdiff = NULL;
+        cold->getspec = NULL;
+        cold->shade = NULL;
     }
     return obj;
 }
 
-void set_nan(obj_t* obj)
-{
-    obj->hitloc[X] = FP_NAN; 
-    obj->hitloc[Y] = FP_NAN; 
-    obj->hitloc[Z] = FP_NAN;
-    obj->normal[X] = FP_NAN; 
-    obj->normal[Y] = FP_NAN; 
-    obj->normal[Z] = FP_NAN; 
-}
-
 void kill_dummy(void* obj)
 {
     obj_t* object = (obj_t*)obj;
@@ -74,65 +74,107 @@
 /* Includes the wrapper Malloc function. */
 #include "utils.h"
 
+/* Includes the scene reader that objects are read through. */
+#include "scenefile.h"
+
 /* Forward declarion of the obj_t typedef for material.h. */
 
 typedef struct obj_type obj_t;
 
+/*
+ * The hit_type struct, typedefed as hit_t. It records where a single ray hit
+ * an object, so that the objects themselves are never written to while an
+ * image is being drawn.
+ *
+ * Data Member: t  The distance along the ray to the hit.
+ * Data Member: hitloc The position the object was hit at.
+ * Data Member: normal The normal of the object at hitloc.
+ * Data Member: obj  The object that was hit.
+ */
+typedef struct hit_type
+{
+    real_t t;
+    real_t hitloc[DIMENSIONS];
+    real_t normal[DIMENSIONS];
+    obj_t* obj;
+} hit_t;
+
+/* Forward declaration of the shade_t typedef, defined in material.h. */
+typedef struct shade_type shade_t;
+
 /* This file includes the material_type struct necessary for the obj_t struct.
  */
 #include "material.h"
 
 
 /* 
- * The object_type struct, typedefed as obj_t. It represents a "node" in the 
- * linked list. 
- *
- * Data Member: next  The next node in the list.
- * Data Member: priv  The private data held by this node. It can be any type.
- * Data Member: objid This object's unique id, indicating in what order 
- *                    the objects were created.
+ * The object_cold_type struct, typedefed as obj_cold_t. It holds the parts of
+ * an object that are only needed once a ray has been found to hit it, kept
+ * apart from obj_t so the hit tests don't pull them into the cache.
  *
- * Function Member: hits  The hits function for the appropriate object type,
- *                        determining if a ray hits this object.
+ * Function Member: surface  Fills a hit_t with the location and normal where
+ *                           a ray hits this object, given the distance that
+ *                           hits returned. It is run once, for the winner.
  * Function Member: getamb A plugin function for returning the ambient values 
- *                         of a non-light object.
+ *                         of a non-light object at a hit.
  * Function Member: getdiff A plugin function for returning the diffuse light
- *                          values from a non-light object.
+ *                          values from a non-light object at a hit.
  * Function Member: getspec A plugin function for returning the specular light
- *                          values from a non-light object. 
+ *                          values from a non-light object at a hit. 
+ * Function Member: shade  Fills in the shading record for a hit, once, from
+ *                         the plugins above.
  *
  * Data Member: material The material data contained by an object. material 
  *                       holds the diffuse, ambient, and specular light 
  *                       information.
- * Data Member: hitloc The position the object was hit at.
- * Data Member: normal The normal of the ray that hit the object. 
+ * Data Member: lights  The slots, in the model's lights, of every light that
+ *                      can reach this object, or NULL to try every light.
+ * Data Member: num_lights  The number of slots in lights.
+ */
+typedef struct obj_cold_type
+{
+    void    (*surface)(real_t* base, real_t* dir, real_t t, obj_t*, hit_t*);
+    void    (*getamb)(obj_t*, hit_t*, real_t*);
+    void    (*getdiff)(obj_t*, hit_t*, real_t*);
+    void    (*getspec)(obj_t*, hit_t*, real_t*);
+    void    (*shade)(obj_t*, hit_t*, shade_t*);
+
+    material_t material;
+
+    int* lights;
+    int num_lights;
+} obj_cold_t;
+
+/* 
+ * The object_type struct, typedefed as obj_t. It represents a record in an
+ * object store, and holds only what the hit tests read, so that several
+ * records share a cache line.
  *
- * Function Member: kill  The function containing instructions necessary to kill
- *                        inner information inside of priv data.
+ * Data Member: objtype The type of the object.
+ * Data Member: objid This object's unique id, indicating in what order 
+ *                    the objects were created. Ties between hits are broken
+ *                    by it.
  *
+ * Function Member: hits  The hits function for the appropriate object type,
+ *                        determining if a ray hits this object and how far
+ *                        away. Only the distance is found, since most tests
+ *                        are lost to a closer object.
+ *
+ * Data Member: priv  The private data held by this record. It can be any type.
+ * Data Member: cold  The rest of the object, read once it has been hit.
  */
 struct obj_type
 {
-    struct obj_type* next;
     int objtype;
     int objid;
 
-    double  (*hits) (double* base, double* dir, struct obj_type*);
-    void    (*getamb)(struct obj_type*, double*);
-    void    (*getdiff)(struct obj_type*, double*);
-    void    (*getspec)(struct obj_type*, double*);
-
-    material_t material;
+    real_t  (*hits) (real_t* base, real_t* dir, struct obj_type*);
 
     void    *priv;
-
-    double  hitloc[DIMENSIONS];
-    double  normal[DIMENSIONS];
+    obj_cold_t* cold;
 };
 
-obj_t* object_init(FILE *in, int objtype);
-
-void set_nan(obj_t* obj);
+obj_t* object_init(scene_in_t* in, int objtype);
 
 void kill_dummy(void* obj);
 
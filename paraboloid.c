@@ -14,24 +14,18 @@
  * Param: objtype  The object type of the object we are creating.
  * Return:  The new object that has been created.
  */
-obj_t* parab_init(FILE* in, int objtype)
+obj_t* parab_init(scene_in_t* in, int objtype)
 {
-    char buff[BUFF_SIZE];
     int pcount = 0;
     obj_t* obj = object_init(in, objtype);
     if (obj)
     {
         parab_t* parab = Malloc(sizeof(parab_t));
-        pcount += fscanf(in, "%lf %lf %lf",
-                         &parab->center[X], &parab->center[Y], 
-                         &parab->center[Z]);
-        fgets(buff, BUFF_SIZE, in);
-        pcount += fscanf(in, "%lf %lf %lf",
-                         &parab->centerline[X], &parab->centerline[Y], 
-                         &parab->centerline[Z]);
-        fgets(buff, BUFF_SIZE, in);
-        pcount += fscanf(in, "%lf %lf", &parab->radius, &parab->height);
-        fgets(buff, BUFF_SIZE, in);
+        pcount += scene_read(in, 3, &parab->center[X], &parab->center[Y],
+                             &parab->center[Z]);
+        pcount += scene_read(in, 3, &parab->centerline[X],
+                             &parab->centerline[Y], &parab->centerline[Z]);
+        pcount += scene_read(in, 2, &parab->radius, &parab->height);
         if (pcount != PARAB_OBJS)
         {
             fprintf(stderr, "Error found in parab_init...\n");
@@ -40,7 +34,7 @@ obj_t* parab_init(FILE* in, int objtype)
         else
         {
             parab->scale = pow(parab->radius, SQUARED) / parab->height;
-            double id_matrix[XYZ][XYZ];
+            real_t id_matrix[XYZ][XYZ];
             get_id_matrix(id_matrix);
             /* Adjustment for shapes aligned with the negative y axis. This
              * is a minor hack to adjust for this bad case. */
@@ -56,7 +50,11 @@ obj_t* parab_init(FILE* in, int objtype)
             cross_prod(parab->rotmat[X], parab->rotmat[Y], parab->rotmat[Z]);
             unitvec3(parab->rotmat[Z], parab->rotmat[Z]);
             transpose_mat(parab->rotmat, parab->irot);
-            obj->hits = parab_hits;
+            parab->aligned = (parab->centerline[X] == 0 &&
+                              parab->centerline[Y] != 0 &&
+                              parab->centerline[Z] == 0);
+            obj->hits = parab->aligned ? parab_hits_aligned : parab_hits;
+            obj->cold->surface = parab_surface;
             obj->priv = parab;
         }
     }
@@ -64,7 +62,8 @@ obj_t* parab_init(FILE* in, int objtype)
 }
 
 /*
- * Function for determining if a ray hit a paraboloid.
+ * Function for determining if a ray hit a paraboloid. The ray is rotated into
+ * the paraboloid's own space, where its centerline is the y axis.
  *
  * Param: base  The starting point for the ray.
  * Param: dir   The direction of the approaching ray.
@@ -73,37 +72,53 @@ obj_t* parab_init(FILE* in, int objtype)
  * Return: The distance from our viewpoint that the object is at, if we hit.
  *         If we miss, returns -1.
  */
-double parab_hits(double* base, double* olddir, obj_t* obj)
+real_t parab_hits(real_t* base, real_t* olddir, obj_t* obj)
 {
-    double t = MISS;
     parab_t* parab = (parab_t*)obj->priv;
-    double newbase[XYZ];
-    double newcenter[XYZ];
-    double dir[XYZ];
-    copy3(olddir, dir);
-    diff3(parab->center, base, newbase);
-    diff3(parab->center, parab->center, newcenter);
-    double idmat[XYZ][XYZ];
-    get_id_matrix(idmat);
-    if (!(parab->centerline[X] == idmat[Y][X] && parab->centerline[Y] != 0 && 
-          parab->centerline[Z] == idmat[Y][Z]))
-    {
-        transform(parab->rotmat, newbase, newbase);
-        transform(parab->rotmat, dir, dir);
-    }
-    else
-    {
-        transform(idmat, newbase, newbase);
-        transform(idmat, olddir, dir);
-    }
-    double a = pow(dir[X], SQUARED) + pow(dir[Z], SQUARED);
-    double b = 2 * (newbase[X] * dir[X] + newbase[Z] * dir[Z]) - 
-               parab->scale  * dir[Y];
-    double c = (pow(newbase[X], SQUARED) + pow(newbase[Z], SQUARED)) -
-                parab->scale * newbase[Y];
-    double discrim = (pow(b, SQUARED) - 4 * a * c);
-    double t1 = ((-1 * b) - sqrt(discrim))/(2 * a);
-    double t2 = ((-1 * b) + sqrt(discrim))/(2 * a);
+    vec3_t newbase = vec3_sub(vec3_load(base), vec3_load(parab->center));
+    return parab_solve(obj, vec3_xform(parab->rotmat, newbase),
+                       vec3_xform(parab->rotmat, vec3_load(olddir)));
+}
+
+/*
+ * Function for determining if a ray hit a paraboloid whose centerline is
+ * already the y axis, so only the translation is needed.
+ *
+ * Param: base  The starting point for the ray.
+ * Param: dir   The direction of the approaching ray.
+ * Param: obj   The paraboloid object that is being tested for hits.
+ *
+ * Return: The distance from our viewpoint that the object is at, if we hit.
+ *         If we miss, returns -1.
+ */
+real_t parab_hits_aligned(real_t* base, real_t* dir, obj_t* obj)
+{
+    parab_t* parab = (parab_t*)obj->priv;
+    vec3_t newbase = vec3_sub(vec3_load(base), vec3_load(parab->center));
+    return parab_solve(obj, newbase, vec3_load(dir));
+}
+
+/*
+ * Solves for where a ray already in the paraboloid's space meets it.
+ *
+ * Param: obj   The paraboloid object being tested.
+ * Param: newbase  The start of the ray relative to the paraboloid.
+ * Param: dir   The direction of the ray in the paraboloid's space.
+ *
+ * Return: The distance to the closest hit, or MISS.
+ */
+real_t parab_solve(obj_t* obj, vec3_t newbase, vec3_t dir)
+{
+    real_t t = MISS;
+    parab_t* parab = (parab_t*)obj->priv;
+    real_t a = dir.x * dir.x + dir.z * dir.z;
+    real_t b = 2 * (newbase.x * dir.x + newbase.z * dir.z) - 
+               parab->scale  * dir.y;
+    real_t c = (newbase.x * newbase.x + newbase.z * newbase.z) -
+                parab->scale * newbase.y;
+    real_t discrim = (b * b - 4 * a * c);
+    real_t t1 = ((-1 * b) - sqrt(discrim))/(2 * a);
+    real_t t2 = ((-1 * b) + sqrt(discrim))/(2 * a);
     t2 = (check_parab_hit (obj, dir, newbase, t2));
     t1 = (check_parab_hit (obj, dir, newbase, t1));
     if (t1 == MISS)
@@ -123,49 +138,79 @@ double parab_hits(double* base, double* olddir, obj_t* obj)
 
 /*
  * Function for checking both the positive and negative side of the quadratic
- * hit function.
+ * hit function. Only the height of the hit is needed to decide, so the rest
+ * of the hit is left to parab_surface.
  *
- * Param: obj  The object to check hits with and store a hitpoint in.
+ * Param: obj  The object to check hits with.
  * Param: dir  The direction of the current ray.
  * Param: newbase  The base of the ray we are shooting.
  * Param: t  The current distance from the object.
  *
- * return:  The new t value, representing the distance from the object.
+ * Return:  The new t value, representing the distance from the object.
  */
-double check_parab_hit(obj_t* obj, double* dir, double* newbase, double t)
+real_t check_parab_hit(obj_t* obj, vec3_t dir, vec3_t newbase, real_t t)
 {
     parab_t* parab = (parab_t*)(obj->priv);
-    double hit[XYZ];
-    double scaled_d[XYZ];
-    double normal[XYZ];
-    scale3(t, dir, scaled_d);
-    sum3(newbase, scaled_d, hit);
-    if (hit[Y] < 0 || hit[Y] > parab->height) 
+    real_t hit_y = newbase.y + t * dir.y;
+    if (hit_y < 0 || hit_y > parab->height)
     {
         t = MISS;
     }
-    else
+    return t;
+}
+
+/*
+ * Function for finding the hit location and normal on a paraboloid. The ray is
+ * moved into the paraboloid's space the same way the hits function moved it.
+ *
+ * Param: base  The starting point for the ray.
+ * Param: dir_start  The direction of the approaching ray.
+ * Param: t     The distance returned by the hits function.
+ * Param: obj   The paraboloid object that was hit.
+ * Param: record  Output for the hit location and normal.
+ */
+void parab_surface(real_t* base, real_t* dir_start, real_t t, obj_t* obj,
+                   hit_t* record)
+{
+    parab_t* parab = (parab_t*)obj->priv;
+    vec3_t newbase = vec3_sub(vec3_load(base), vec3_load(parab->center));
+    vec3_t dir = vec3_load(dir_start);
+    if (!parab->aligned)
     {
-        double idmat[XYZ][XYZ];
-        get_id_matrix(idmat);
-        normal[X] = 2 * hit[X];
-        normal[Y] = -1 * parab->scale;
-        normal[X] = 2 * hit[Z];
-        if (!(parab->centerline[X] == idmat[Y][X] && 
-              parab->centerline[Y] != 0 &&
-              parab->centerline[Z] == idmat[Y][Z]))
-        {
-            transform(parab->irot, hit, obj->hitloc);
-            transform(parab->irot, normal, obj->normal);
-        }
-        else
-        {
-            transform(idmat, hit, obj->hitloc);
-            transform(idmat, normal, obj->normal);
-        }
-        sum3(obj->hitloc, parab->center, obj->hitloc);
+        newbase = vec3_xform(parab->rotmat, newbase);
+        dir = vec3_xform(parab->rotmat, dir);
     }
-    return t;
+    vec3_t hit = vec3_along(newbase, dir, t);
+    vec3_t normal = vec3(2 * hit.x, -1 * parab->scale, 2 * hit.z);
+    if (!parab->aligned)
+    {
+        hit = vec3_xform(parab->irot, hit);
+        normal = vec3_xform(parab->irot, normal);
+    }
+    vec3_store(vec3_add(hit, vec3_load(parab->center)), record->hitloc);
+    vec3_store(normal, record->normal);
+}
+
+/*
+ * Function for finding the world space bounds of a paraboloid. The sides
+ * bulge outward, so the box is taken around a cylinder as wide as the top.
+ *
+ * Param: obj  The paraboloid object to bound.
+ * Param: box  The output box.
+ *
+ * Return: BOUNDED.
+ */
+int parab_bounds(obj_t* obj, bbox_t* box)
+{
+    parab_t* parab = (parab_t*)obj->priv;
+    real_t top[XYZ];
+    real_t radius = sqrt(fabs(parab->scale * parab->height));
+    scale3(parab->height, parab->rotmat[Y], top);
+    sum3(parab->center, top, top);
+    box_empty(box);
+    box_add_disc(box, parab->center, parab->rotmat[Y], radius);
+    box_add_disc(box, top, parab->rotmat[Y], radius);
+    return BOUNDED;
 }
 
 /*
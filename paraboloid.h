@@ -14,10 +14,12 @@
 #include "utils.h"
 /* Included for doing matrix operations. */
 #include "matlib.h"
+/* Included for the bbox_t struct. */
+#include "bbox.h"
 /* Defines the number of dimensions in XYZ. */
 #define XYZ 3
 /* Constant for a squaring operation. */
-#define SQUARED 2
+#define SQUARED 2.0
 /* Defining the correct number of objects to read in from the input file. */
 #define PARAB_OBJS 8
 
@@ -33,24 +35,36 @@
  * Data Member: rotmat  The rotation matrix necessary for rotating this object
  *              to make hit detection easier.
  * Data Member: irot  The transpose of rotmat, for reversing the transformation.
+ * Data Member: aligned  Nonzero when the centerline already points along +y,
+ *                       so rays need no rotation into the paraboloid's space.
  */
 typedef struct parab_type
 {
-    double center[XYZ];
-    double centerline[XYZ];
-    double radius;
-    double height;
-    double scale; /* r^2 / h */
-    double rotmat[XYZ][XYZ];
-    double irot[XYZ][XYZ];
+    real_t center[XYZ];
+    real_t centerline[XYZ];
+    real_t radius;
+    real_t height;
+    real_t scale; /* r^2 / h */
+    real_t rotmat[XYZ][XYZ];
+    real_t irot[XYZ][XYZ];
+    int aligned;
 } parab_t;
 
-obj_t* parab_init(FILE* in, int objtype);
+obj_t* parab_init(scene_in_t* in, int objtype);
 
-double parab_hits(double* base, double* dir, obj_t* obj);
+real_t parab_hits(real_t* base, real_t* dir, obj_t* obj);
+
+real_t parab_hits_aligned(real_t* base, real_t* dir, obj_t* obj);
+
+real_t parab_solve(obj_t* obj, vec3_t newbase, vec3_t dir);
+
+int parab_bounds(obj_t* obj, bbox_t* box);
 
 void dump_parab (FILE* out, obj_t* obj);
 
 void kill_parab(void* parab);
 
-double check_parab_hit(obj_t* obj, double* dir, double* newbase, double t);
+real_t check_parab_hit(obj_t* obj, vec3_t dir, vec3_t newbase, real_t t);
+
+void parab_surface(real_t* base, real_t* dir, real_t t, obj_t* obj,
+                   hit_t* record);
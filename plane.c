@@ -18,23 +18,16 @@
  *
  * Return: obj  The constructed and initialized object.
  */
-obj_t* plane_init(FILE* in, int objtype)
+obj_t* plane_init(scene_in_t* in, int objtype)
 {
-    char buff[BUFF_SIZE];
     obj_t* obj = NULL;
     int pcount = 0;
     obj = object_init(in, objtype);
     plane_t* plane = Malloc(sizeof(plane_t));
-    pcount += fscanf(in, "%lf %lf %lf",
-                     &plane->normal[X],
-                     &plane->normal[Y],
-                     &plane->normal[Z]);
-    fgets(buff, BUFF_SIZE, in);
-    pcount += fscanf(in, "%lf %lf %lf",
-                     &plane->point[X],
-                     &plane->point[Y],
-                     &plane->point[Z]);
-    fgets(buff, BUFF_SIZE, in);
+    pcount += scene_read(in, 3, &plane->normal[X], &plane->normal[Y],
+                         &plane->normal[Z]);
+    pcount += scene_read(in, 3, &plane->point[X], &plane->point[Y],
+                         &plane->point[Z]);
     if (pcount != PLANE_OBJS || obj == NULL)
     {
         fprintf(stderr, "Error found in plane_init...\n");
@@ -42,7 +35,9 @@ obj_t* plane_init(FILE* in, int objtype)
     }
     else
     {
+        plane->n_dot_q = dot3(plane->normal, plane->point);
         obj->hits = hits_plane;
+        obj->cold->surface = surface_plane;
         obj->priv = plane;
     }
     return obj;
@@ -58,49 +53,91 @@ obj_t* plane_init(FILE* in, int objtype)
  * Return: The distance from our viewpoint that the object is at, if we hit.
  *         If we miss, returns -1.
  */
-double hits_plane(double* base, double* dir, obj_t* obj)
+real_t hits_plane(real_t* base, real_t* dir, obj_t* obj)
 { 
-    obj->hitloc[X] = FP_NAN; /* Start values at NAN to help debug. */
-    obj->hitloc[Y] = FP_NAN;
-    obj->hitloc[Z] = FP_NAN;
-    obj->normal[X] = FP_NAN;
-    obj->normal[Y] = FP_NAN;
-    obj->normal[Z] = FP_NAN;
-    double* d = Malloc(sizeof(double) * DIMENSIONS);
-    unitvec3(dir, d);
     plane_t* plane = (plane_t*)obj->priv;
-    double n_dot_d = dot3(plane->normal, d);
-    double n_dot_q = dot3(plane->normal, plane->point);
+    return plane_distance(plane, vec3_load(base), vec3_unit(vec3_load(dir)));
+}
+
+/*
+ * Function for finding the hit location and normal on a plane. It is shared
+ * by every kind of plane, since they differ only in where they can be hit.
+ *
+ * Param: base  The starting point for the ray.
+ * Param: dir   The direction of the approaching ray.
+ * Param: t     The distance returned by the hits function.
+ * Param: obj   The plane object that was hit.
+ * Param: hit   Output for the hit location and normal.
+ */
+void surface_plane(real_t* base, real_t* dir, real_t t, obj_t* obj,
+                   hit_t* hit)
+{
+    plane_record((plane_t*)obj->priv, vec3_load(base),
+                 vec3_unit(vec3_load(dir)), t, hit);
+}
+
+/*
+ * The distance only part of hits_plane. Nothing but the distance is
+ * computed, so it is cheap enough to run against every unbounded plane on
+ * every ray, and the direction is normalized once by the caller. Planes are
+ * only seen where they lie at or behind the screen, at z <= 0.
+ *
+ * Param: plane  The plane to test.
+ * Param: base   The starting point for the ray.
+ * Param: d      The unit direction of the ray.
+ *
+ * Return: The distance along d to the plane, or MISS.
+ */
+real_t plane_distance(plane_t* plane, vec3_t base, vec3_t d)
+{
+    vec3_t normal = vec3_load(plane->normal);
+    real_t n_dot_d = vec3_dot(normal, d);
     if (0 == n_dot_d)
     {
-        free(d);
-        return MISS;
-    }
-    double n_dot_v = dot3(plane->normal, base);
-    double t_sub_h = (n_dot_q - n_dot_v) / n_dot_d;
-    if (0 > t_sub_h)
-    {
-        free(d);
         return MISS;
     }
-    double* scaled_d = Malloc(sizeof(double) * DIMENSIONS);
-    scale3(t_sub_h, d, scaled_d);
-    sum3(base, scaled_d, obj->hitloc);
-    free(scaled_d);
-    free(d);
-    if (obj->hitloc[Z] > ROUNDING_ADJUSTMENT)
+    real_t n_dot_v = vec3_dot(normal, base);
+    real_t t_sub_h = (plane->n_dot_q - n_dot_v) / n_dot_d;
+    if (0 > t_sub_h || base.z + t_sub_h * d.z > ROUNDING_ADJUSTMENT)
     {
         return MISS;
     }
-    else
-    {
-        obj->normal[X] = plane->normal[X];
-        obj->normal[Y] = plane->normal[Y];
-        obj->normal[Z] = plane->normal[Z];
-    }
     return t_sub_h;
 }
 
+/*
+ * Fills in the hit record for a ray found to hit a plane by plane_distance.
+ *
+ * Param: plane  The plane that was hit.
+ * Param: base   The starting point for the ray.
+ * Param: d      The unit direction of the ray.
+ * Param: t      The distance returned by plane_distance.
+ * Param: hit    Output for the hit location and normal.
+ */
+void plane_record(plane_t* plane, vec3_t base, vec3_t d, real_t t,
+                  hit_t* hit)
+{
+    vec3_store(vec3_along(base, d, t), hit->hitloc);
+    vec3_store(vec3_load(plane->normal), hit->normal);
+}
+
+/*
+ * Function for finding the bounds of a plane. Planes are infinite, so this
+ * always flags the plane as unbounded and leaves the box untouched. Spatial
+ * indexes must keep these objects apart and test them on every ray.
+ *
+ * Param: obj  The plane object.
+ * Param: box  The output box, which is not written.
+ *
+ * Return: UNBOUNDED.
+ */
+int plane_bounds(obj_t* obj, bbox_t* box)
+{
+    (void)obj;
+    (void)box;
+    return UNBOUNDED;
+}
+
 /*
  * Function for dumping the data about plane objects.
  * Param: out  The stream to dump to.
@@ -20,6 +20,9 @@
 
 #include "veclib.h"
 
+/* Includes the bbox_t struct for reporting bounds. */
+#include "bbox.h"
+
 /* Includes the object structs and other necessary structs. */
 #include "object.h"
 
@@ -30,18 +33,30 @@
  * Data Member: point  Some point on the plane.
  * Data Member: normal The normal (perpendicular) vector of the plane, 
  *              determining the orientation.
+ * Data Member: n_dot_q The dot product of normal and point, set at init.
  */
 typedef struct plane_type
 {
-    double point[VEC_SIZE];
-    double normal[VEC_SIZE];
+    real_t point[VEC_SIZE];
+    real_t normal[VEC_SIZE];
+    real_t n_dot_q;
     void *priv;
 } plane_t;
 
-obj_t* plane_init(FILE* in, int objtype);
+obj_t* plane_init(scene_in_t* in, int objtype);
 
 void dump_plane(FILE* out, obj_t* obj);
 
-double hits_plane(double* base, double* dir, obj_t* obj);
+real_t hits_plane(real_t* base, real_t* dir, obj_t* obj);
+
+void surface_plane(real_t* base, real_t* dir, real_t t, obj_t* obj,
+                   hit_t* hit);
+
+real_t plane_distance(plane_t* plane, vec3_t base, vec3_t d);
+
+void plane_record(plane_t* plane, vec3_t base, vec3_t d, real_t t,
+                  hit_t* hit);
+
+int plane_bounds(obj_t* obj, bbox_t* box);
 
 void kill_plane(void* plane);
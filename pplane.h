@@ -16,7 +16,7 @@
 /* Includes the readin functions and the FILE type. */
 #include "stdio.h"
 /* Included for using math functions in the procedural formulas. */
-#include <math.h>
+#include <tgmath.h>
 /* Includes rand and some other functions. */
 #include <stdlib.h>
 /* Includes time in case we rand. */
@@ -24,12 +24,12 @@
 /* Includes vec_get1 function. */
 #include "utils.h"
 
-void pplane0_amb(obj_t* obj, double* value);
+void pplane0_amb(obj_t* obj, hit_t* hit, real_t* value);
 
-void pplane1_amb(obj_t* obj, double* value);
+void pplane1_amb(obj_t* obj, hit_t* hit, real_t* value);
 
-void pplane2_amb(obj_t* obj, double* value);
+void pplane2_amb(obj_t* obj, hit_t* hit, real_t* value);
 
-void pplane3_amb(obj_t* obj, double* value);
+void pplane3_amb(obj_t* obj, hit_t* hit, real_t* value);
 
-obj_t* pplane_init(FILE* in, int objtype);
+obj_t* pplane_init(scene_in_t* in, int objtype);
@@ -0,0 +1,113 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * A small tool that compares two binary PPM images, as written by
+ * make_image, and checks the difference against a tolerance. It prints the
+ * largest error in each channel and the peak signal to noise ratio, and
+ * exits with failure if the images differ by more than allowed.
+ *
+ * Usage: ppmcmp <golden.ppm> <test.ppm> <max error> <min psnr>
+ */
+
+/* Included for the math functions used in the PSNR. */
+#include <math.h>
+
+/* Includes stdio, stdlib and the Malloc wrapper. */
+#include "utils.h"
+
+/* The number of arguments this tool takes, including its name. */
+#define CMP_ARGS 5
+
+/* The largest value a channel may hold. */
+#define CMP_MAX_COLOR 255
+
+/* The number of color channels in a pixel. */
+#define CMP_CHANNELS 3
+
+/*
+ * Reads a binary PPM image.
+ *
+ * Param: filename  The file to read.
+ * Param: width     Output for the width of the image.
+ * Param: height    Output for the height of the image.
+ *
+ * Return: The pixel bytes, or NULL if the file could not be read.
+ */
+unsigned char* read_ppm(char* filename, int* width, int* height)
+{
+    int maxval;
+    FILE* in = fopen(filename, "rb");
+    if (NULL == in)
+    {
+        fprintf(stderr, "Unable to open %s.\n", filename);
+        return NULL;
+    }
+    if (fscanf(in, "P6 %d %d %d", width, height, &maxval) != 3 ||
+        maxval != CMP_MAX_COLOR || fgetc(in) == EOF)
+    {
+        fprintf(stderr, "%s is not a binary PPM image.\n", filename);
+        fclose(in);
+        return NULL;
+    }
+    size_t size = (size_t)*width * (size_t)*height * CMP_CHANNELS;
+    unsigned char* pixels = Malloc(size);
+    if (fread(pixels, 1, size, in) != size)
+    {
+        fprintf(stderr, "%s is shorter than its header says.\n", filename);
+        free(pixels);
+        pixels = NULL;
+    }
+    fclose(in);
+    return pixels;
+}
+
+int main(int argc, char** argv)
+{
+    int gwidth, gheight, twidth, theight;
+    if (argc != CMP_ARGS)
+    {
+        fprintf(stderr, "Usage: %s <golden.ppm> <test.ppm> <max error> "
+                        "<min psnr>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    int max_error = atoi(argv[3]);
+    double min_psnr = atof(argv[4]);
+    unsigned char* golden = read_ppm(argv[1], &gwidth, &gheight);
+    unsigned char* test = read_ppm(argv[2], &twidth, &theight);
+    if (NULL == golden || NULL == test)
+    {
+        free(golden);
+        free(test);
+        return EXIT_FAILURE;
+    }
+    if (gwidth != twidth || gheight != theight)
+    {
+        fprintf(stderr, "Image sizes differ: %dx%d against %dx%d.\n",
+                gwidth, gheight, twidth, theight);
+        free(golden);
+        free(test);
+        return EXIT_FAILURE;
+    }
+    int worst[CMP_CHANNELS] = {0, 0, 0};
+    double squares = 0.0;
+    size_t size = (size_t)gwidth * (size_t)gheight * CMP_CHANNELS;
+    for (size_t i = 0; i < size; i++)
+    {
+        int diff = abs(golden[i] - test[i]);
+        worst[i % CMP_CHANNELS] = diff > worst[i % CMP_CHANNELS] ?
+                                  diff : worst[i % CMP_CHANNELS];
+        squares += (double)(diff * diff);
+    }
+    /* Identical images have no noise, so their PSNR is infinite. */
+    double mse = squares / (double)size;
+    double psnr = mse > 0 ? 10.0 * log10(CMP_MAX_COLOR * CMP_MAX_COLOR / mse)
+                          : INFINITY;
+    int pass = worst[0] <= max_error && worst[1] <= max_error &&
+               worst[2] <= max_error && psnr >= min_psnr;
+    printf("max_error=%d,%d,%d psnr=%.2f %s\n", worst[0], worst[1], worst[2],
+           psnr, pass ? "pass" : "FAIL");
+    free(golden);
+    free(test);
+    return pass ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -22,21 +22,14 @@
  *           Received from the command line.
  * Return: proj  The fully initialized projection (type proj_t pointer).
  */
-proj_t* projection_init(int x, int y, FILE* in)
+proj_t* projection_init(int x, int y, scene_in_t* in)
 {
-    char buff[BUFF_SIZE];
     proj_t* proj = Malloc(sizeof(proj_t));
     proj->win_size_pixel[X] = x;
     proj->win_size_pixel[Y] = y;
-    fscanf(in, " %lf %lf",
-            &proj->win_size_world[X],
-            &proj->win_size_world[Y]);
-    fgets(buff, BUFF_SIZE, in);
-    fscanf(in, " %lf %lf %lf",
-            &proj->view_point[X],
-            &proj->view_point[Y],
-            &proj->view_point[Z]);
-    fgets(buff, BUFF_SIZE, in);
+    scene_read(in, 2, &proj->win_size_world[X], &proj->win_size_world[Y]);
+    scene_read(in, 3, &proj->view_point[X], &proj->view_point[Y],
+               &proj->view_point[Z]);
     return proj;     
 }
 
@@ -56,9 +49,9 @@ void projection_dump(FILE* out, proj_t* proj)
                  "End of Projection Dump\n",
                  proj->win_size_pixel[X],
                  proj->win_size_pixel[Y],
-                 proj->win_size_world[X], 
-                 proj-> win_size_world[Y],
-                 proj->view_point[X],
-                 proj->view_point[Y],
-                 proj->view_point[Z]);
+                 (double)proj->win_size_world[X],
+                 (double)proj->win_size_world[Y],
+                 (double)proj->view_point[X],
+                 (double)proj->view_point[Y],
+                 (double)proj->view_point[Z]);
 }
@@ -14,6 +14,9 @@
 /* Includes utility functions such as Malloc for use in projection.c*/
 #include "utils.h"
 
+/* Includes the rng_t struct used to jitter anti-aliasing samples. */
+#include "rng.h"
+
 #define X_BY_Y 2
 
 /*
@@ -28,12 +31,12 @@
 typedef struct projection_type 
 {
     int win_size_pixel[X_BY_Y];
-    double win_size_world[X_BY_Y];
-    double view_point[DIMENSIONS];
+    real_t win_size_world[X_BY_Y];
+    real_t view_point[DIMENSIONS];
 } proj_t;
 
-proj_t* projection_init(int x, int y, FILE* in);
+proj_t* projection_init(int x, int y, scene_in_t* in);
 
 void projection_dump(FILE* out, proj_t* proj);
 
-void map_pix_to_world(proj_t* proj, int x, int y, double* world);
+void map_pix_to_world(proj_t* proj, int x, int y, rng_t* rng, real_t* world);
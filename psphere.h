@@ -17,7 +17,7 @@
 /* Includes the readin functions and the FILE type. */
 #include "stdio.h"
 /* Included for using math functions in the procedural formulas. */
-#include <math.h>
+#include <tgmath.h>
 /* Includes rand and some other functions. */
 #include <stdlib.h>
 /* Includes time in case we rand. */
@@ -25,12 +25,12 @@
 /* Includes vec_get1 function. */
 #include "utils.h"
 
-obj_t* psphere_init(FILE* in, int objtype);
+obj_t* psphere_init(scene_in_t* in, int objtype);
 
-void psphere0_amb(obj_t* obj, double* value); 
+void psphere0_amb(obj_t* obj, hit_t* hit, real_t* value); 
 
-void psphere1_amb(obj_t* obj, double* value);
+void psphere1_amb(obj_t* obj, hit_t* hit, real_t* value);
 
-void psphere2_amb(obj_t* obj, double* value);
+void psphere2_amb(obj_t* obj, hit_t* hit, real_t* value);
 
-void psphere3_amb(obj_t* obj, double* value);
+void psphere3_amb(obj_t* obj, hit_t* hit, real_t* value);
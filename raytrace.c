@@ -10,8 +10,47 @@
  * The header file containing our includes.
  */
 #include "raytrace.h"
+/*
+ * One hit along a path of reflections, kept on the stack in ray_trace until
+ * the light reflected into it is known.
+ *
+ * Data Member: local    The light seen at the hit before any reflection is
+ *                       added, already divided by the distance travelled.
+ * Data Member: specref  The specular reflectance of the object hit.
+ */
+typedef struct ray_frame_type
+{
+    real_t local[RGB_SIZE];
+    real_t specref[RGB_SIZE];
+} ray_frame_t;
+
+/*
+ * Finds the smallest distance at which a hit counts for a ray. Rounding
+ * errors in a hit grow with the size of the coordinates involved, so the
+ * limit is HIT_EPSILON scaled by the magnitudes of the coordinates of the
+ * ray's start.
+ *
+ * Param: base  The starting point of the ray.
+ *
+ * Return: The distance below which hits are ignored.
+ */
+real_t hit_epsilon(real_t* base)
+{
+    real_t size = 1;
+    for (int i = 0; i < XYZ; i++)
+    {
+        size += fabs(base[i]);
+    }
+    return HIT_EPSILON * size;
+}
+
 /* 
- * This function traces a ray for an individual pixel.
+ * This function traces a ray for an individual pixel. The ray is followed
+ * forwards through every specular bounce, pushing the light seen at each hit
+ * onto an explicit stack, and the stack is then unwound so that each hit
+ * adds in the light reflected into it from the next. Following stops when
+ * the ray misses, hits something that doesn't reflect, or reaches any of
+ * the model's limits on reflections, specular throughput and distance.
  *
  * Param: model  Our current model that we are trying to draw.
  * Param: base   The starting point of our ray.
@@ -19,99 +58,236 @@
  * Param: intensity The output array that we will store out pixel data into.
  * Param: total_dist The total distance to the object.
  * Param: last_hit   The object that was hit previously.
+ * Param: rng        The generator lights are drawn from, or NULL if the
+ *                   model adds up every light.
  *
+ * Return: The object this ray hit, or NULL if it hit nothing.
  */
-void ray_trace(model_t *model, double base[DIMENSIONS], double dir[DIMENSIONS], 
-               double intensity[DIMENSIONS], double total_dist, obj_t *last_hit)
+obj_t* ray_trace(model_t *model, real_t base[DIMENSIONS],
+                 real_t dir[DIMENSIONS], real_t intensity[DIMENSIONS],
+                 real_t total_dist, obj_t *last_hit, rng_t* rng)
 {
-    double mindist = MISS;
-    obj_t* closest = NULL;
-    double specref[3] = {0.0, 0.0, 0.0};
-    if (total_dist > MAX_DIST)
+    ray_frame_t stack[MAX_DEPTH + 1];
+    int depth = 0;
+    obj_t* first = NULL;
+    real_t ray_base[DIMENSIONS];
+    real_t ray_dir[DIMENSIONS];
+    vec3_t throughput = vec3(1, 1, 1);
+    vec3_store(vec3_load(base), ray_base);
+    vec3_store(vec3_load(dir), ray_dir);
+    while (model->max_dist <= 0 || total_dist <= model->max_dist)
     {
-        return;
-    }
+        real_t mindist = MISS;
+        hit_t hit;
+        obj_t* closest = find_closest_object(model, ray_base, ray_dir,
+                                             last_hit, &mindist, &hit);
+        if (closest == NULL)
+        {
+            break;
+        }
+        #ifdef DBG_HIT
+            fprintf(stderr, "\nHIT %4d: %5.11f (%5.11lf, %5.11lf, %5.11lf) - "
+                            "The total dist is %lf\n",
+                            closest->objid, mindist,
+                            hit.hitloc[X], hit.hitloc[Y],
+                            hit.hitloc[Z], mindist);
+        #endif
+        ray_frame_t* frame = &stack[depth];
+        /* Only the first hit starts from the light already in intensity. */
+        vec3_store(depth ? vec3(0, 0, 0) : vec3_load(intensity), frame->local);
+        first = depth ? first : closest;
+        depth++;
+        total_dist += mindist;
+        shade_t shade;
+        closest->cold->shade(closest, &hit, &shade);
+        vec3_store(vec3_add(vec3_load(frame->local),
+                            vec3_load(shade.ambient)), frame->local);
+        diffuse_illumination(model, &hit, &shade, rng, frame->local);
+        frame->local[R] /= total_dist;
+        frame->local[G] /= total_dist;
+        frame->local[B] /= total_dist;
+        #ifdef DBG_AMB
+            fprintf(stderr, "AMB (%5.11f, %5.11f, %5.11f) - \n\n", 
+                            frame->local[R], frame->local[G],
+                            frame->local[B]);
+        #endif
 
-    closest = find_closest_object(model->scene, base, dir, last_hit, &mindist);
-    
-    if (closest == NULL)
+        vec3_t specref = vec3_load(shade.specular);
+        vec3_store(specref, frame->specref);
+        throughput = vec3(throughput.x * specref.x, throughput.y * specref.y,
+                          throughput.z * specref.z);
+        if (vec3_dot(specref, specref) <= 0 || depth > model->max_depth ||
+            fmax(throughput.x, fmax(throughput.y, throughput.z)) <
+            model->min_throughput)
+        {
+            break;
+        }
+        vec3_store(vec3_reflect(vec3_load(ray_dir), vec3_load(hit.normal)),
+                   ray_dir);
+        vec3_store(vec3_load(hit.hitloc), ray_base);
+        last_hit = closest;
+        STAT_RAY(RAY_REFLECTION);
+    }
+    /* Adds the light reflected into each hit, from the last hit back. */
+    real_t specint[RGB_SIZE] = {0.0, 0.0, 0.0};
+    while (depth > 0)
     {
-        return;
+        ray_frame_t* frame = &stack[--depth];
+        real_t reflected[RGB_SIZE];
+        reflected[R] = frame->specref[R] * specint[R];
+        reflected[G] = frame->specref[G] * specint[G];
+        reflected[B] = frame->specref[B] * specint[B];
+        vec3_store(vec3_add(vec3_load(frame->local), vec3_load(reflected)),
+                   specint);
     }
-    #ifdef DBG_HIT
-        fprintf(stderr, "\nHIT %4d: %5.11f (%5.11lf, %5.11lf, %5.11lf) - The" 
-                        "total dist is %lf\n",
-                        closest->objid, mindist,
-                        closest->hitloc[X], closest->hitloc[Y],
-                        closest->hitloc[Z], mindist);
-    #endif
-    total_dist += mindist;
-    double ambient[RGB_SIZE];
-    closest->getamb(closest, ambient);
-    sum3(ambient, intensity, intensity);
-    diffuse_illumination(model, closest, intensity);
-    intensity[R] /= total_dist;
-    intensity[G] /= total_dist;
-    intensity[B] /= total_dist;
-    #ifdef DBG_AMB
-        fprintf(stderr, "AMB (%5.11f, %5.11f, %5.11f) - \n\n", 
-                        intensity[R], intensity[G], intensity[B]);
-    #endif
-
-    closest->getspec(closest, specref);
-    if (specref[R] == 0 && specref[G] == 0 && specref[B] == 0)
-        return;
-    if (dot3(specref, specref) > 0)
+    if (first)
     {
-        double specint[RGB_SIZE] = {0.0, 0.0, 0.0};
-        double ref_dir[XYZ];
-        reflect3(dir, closest->normal, ref_dir);
-        ray_trace(model, closest->hitloc, ref_dir, specint, 
-                  total_dist, closest);
-        specref[R] = specref[R] * specint[R];
-        specref[G] = specref[G] * specint[G];
-        specref[B] = specref[B] * specint[B];
+        vec3_store(vec3_load(specint), intensity);
     }
-    sum3(intensity, specref, intensity);
+    return first;
 }
 
 /*
  * This function attempts to determine the closest object that our ray hits.
+ * It searches the model's bounding volume hierarchy when one has been built,
+ * and otherwise falls back on scanning every object in the scene.
  *
+ * Param: model The model containing the scene to search.
  * Param: base The starting point of the current ray.
  * Param: dir  A unit vector representing the current direction of our ray.
  * Param: last_hit The last object that we hit.
  * Param: mindist Output pointer that will hold the distance to the object.
+ * Param: hit  Output for the hit record of the closest object.
  *
  * Return: The closest object in the path of our ray (or NULL if no objects are
  *         in our path).
  */
-obj_t* find_closest_object(list_t* scene, double base[DIMENSIONS], 
-                            double dir[DIMENSIONS], obj_t* last_hit, 
-                            double* mindist)
+obj_t* find_closest_object(model_t* model, real_t base[DIMENSIONS],
+                            real_t dir[DIMENSIONS], obj_t* last_hit,
+                            real_t* mindist, hit_t* hit)
+{
+    if (model->bvh)
+    {
+        return bvh_closest_object(model->bvh, base, dir, last_hit, mindist,
+                                  hit);
+    }
+    return scan_closest_object(model->scene, base, dir, last_hit, mindist,
+                               hit);
+}
+
+/*
+ * This function determines the closest object that our ray hits by testing
+ * every object in the scene. It is kept as the reference for the hierarchy.
+ * Only distances are compared, and the hit record is filled in once for the
+ * closest object. The store is grouped by type, so ties go to the lower
+ * object id, which is the object that comes first in the scene file.
+ *
+ * Param: scene The store of objects to test.
+ * Param: base The starting point of the current ray.
+ * Param: dir  A unit vector representing the current direction of our ray.
+ * Param: last_hit The last object that we hit.
+ * Param: mindist Output pointer that will hold the distance to the object.
+ * Param: hit  Output for the hit record of the closest object.
+ *
+ * Return: The closest object in the path of our ray (or NULL if no objects are
+ *         in our path).
+ */
+obj_t* scan_closest_object(store_t* scene, real_t base[DIMENSIONS], 
+                            real_t dir[DIMENSIONS], obj_t* last_hit, 
+                            real_t* mindist, hit_t* hit)
 {
-    obj_t* node = scene->head;
     obj_t* closest = NULL;
-    while (node != NULL)
+    real_t min_dist = hit_epsilon(base);
+    for (int i = 0; i < scene->count; i++)
     {
+        obj_t* node = &scene->objs[i];
+        if (i + STORE_PREFETCH < scene->count)
+        {
+            __builtin_prefetch(scene->objs[i + STORE_PREFETCH].priv);
+        }
         if (last_hit == NULL || last_hit != node)
         {
-            double dist = node->hits(base, dir, node);
+            real_t dist = node->hits(base, dir, node);
+            STAT_TEST(node->objtype, dist >= min_dist);
             #ifdef DBG_FIND
                 fprintf(stderr, "\nFND %4d: %5.11lf - base X: %f Y: %f Z: %f\n"
-                       "dir X: %lf Y: %lf Z: %lf\nhits: X: %lf Y: %lf Z: %lf\n", 
+                       "dir X: %lf Y: %lf Z: %lf\n", 
                         node->objid, dist, base[X], base[Y], base[Z], 
-                        dir[X], dir[Y], dir[Z], node->hitloc[X], 
-                        node->hitloc[Y], node->hitloc[Z]);
+                        dir[X], dir[Y], dir[Z]);
             #endif
-            if ((*mindist == MISS || dist < *mindist) && 
-                 dist >= ROUNDING_ADJUSTMENT)
+            if ((*mindist == MISS || dist < *mindist ||
+                 (dist == *mindist && closest &&
+                  node->objid < closest->objid)) && dist >= min_dist)
             {
                 *mindist = dist;
                 closest = node;
             }
         }
-        node = node->next;
     }
+    if (closest)
+    {
+        closest->cold->surface(base, dir, *mindist, closest, hit);
+    }
+    hit->t = *mindist;
+    hit->obj = closest;
     return closest;
 }
+
+/*
+ * This function determines if anything blocks a ray before it has travelled
+ * a given distance. Unlike find_closest_object it stops at the first blocker
+ * found, so it is used for shadow rays where any occluder will do.
+ *
+ * Param: model The model containing the scene to search.
+ * Param: base The starting point of the current ray.
+ * Param: dir  The direction of the ray, towards the light.
+ * Param: last_hit The object the ray is leaving, which can't block it.
+ * Param: maxdist The distance past which objects no longer block the ray.
+ *
+ * Return: An object that blocks the ray, or NULL if nothing does.
+ */
+obj_t* find_occluder(model_t* model, real_t base[DIMENSIONS],
+                     real_t dir[DIMENSIONS], obj_t* last_hit, real_t maxdist)
+{
+    if (model->bvh)
+    {
+        return bvh_occluder(model->bvh, base, dir, last_hit, maxdist);
+    }
+    return scan_occluder(model->scene, base, dir, last_hit, maxdist);
+}
+
+/*
+ * This function determines if anything blocks a ray by testing the objects
+ * of the scene in order until one does.
+ *
+ * Param: scene The store of objects to test.
+ * Param: base The starting point of the current ray.
+ * Param: dir  The direction of the ray, towards the light.
+ * Param: last_hit The object the ray is leaving, which can't block it.
+ * Param: maxdist The distance past which objects no longer block the ray.
+ *
+ * Return: An object that blocks the ray, or NULL if nothing does.
+ */
+obj_t* scan_occluder(store_t* scene, real_t base[DIMENSIONS],
+                     real_t dir[DIMENSIONS], obj_t* last_hit, real_t maxdist)
+{
+    real_t min_dist = hit_epsilon(base);
+    for (int i = 0; i < scene->count; i++)
+    {
+        obj_t* node = &scene->objs[i];
+        if (i + STORE_PREFETCH < scene->count)
+        {
+            __builtin_prefetch(scene->objs[i + STORE_PREFETCH].priv);
+        }
+        if (last_hit != node)
+        {
+            real_t dist = node->hits(base, dir, node);
+            STAT_TEST(node->objtype, dist >= min_dist);
+            if (dist >= min_dist && dist <= maxdist)
+            {
+                return node;
+            }
+        }
+    }
+    return NULL;
+}
@@ -7,9 +7,23 @@
  */
 #pragma once
 
-/* Number defining our cap on reflective bounces. */
+/* Number defining our default cap on the distance a ray travels through
+ * reflective bounces. */
 #define MAX_DIST 70.0 //0.0 //70.0 //30.0
 
+/* The most reflective bounces a ray may be followed through, which sizes the
+ * stack in ray_trace, and the default cap. */
+#define MAX_DEPTH 64
+
+/* The default specular throughput below which bounces stop being followed.
+ * Zero follows every bounce that the other caps allow. */
+#define MIN_THROUGHPUT 0.0
+
+/* The smallest distance a hit may lie from the start of a ray, for each unit
+ * of size of the coordinates of that start. It is scaled to the precision of
+ * real_t, so a ray leaving a surface does not hit it again in either build. */
+#define HIT_EPSILON (REAL_EPSILON * 64)
+
 /* This contains the model_t struct that we use in our functions.*/
 #include "model.h"
 /* This includes various vector functions used in determining if a ray hits 
@@ -17,11 +31,25 @@
 #include "veclib.h"
 /* Includes the functions for calculating diffuse lighting. */
 #include "illuminate.h"
+/* Includes the counters for rays and intersection tests. */
+#include "stats.h"
+
+real_t hit_epsilon(real_t* base);
+
+obj_t* ray_trace(model_t* model, real_t base[DIMENSIONS],
+                 real_t dir[DIMENSIONS], real_t intensity[DIMENSIONS],
+                 real_t total_dist, obj_t* last_hit, rng_t* rng);
+
+obj_t* find_closest_object(model_t* model, real_t base[DIMENSIONS], 
+                            real_t dir[DIMENSIONS], 
+                            obj_t* last_hit, real_t* mindist, hit_t* hit);
+
+obj_t* scan_closest_object(store_t* scene, real_t base[DIMENSIONS], 
+                            real_t dir[DIMENSIONS], 
+                            obj_t* last_hit, real_t* mindist, hit_t* hit);
 
-void ray_trace(model_t* model, double base[DIMENSIONS], double dir[DIMENSIONS], 
-               double intensity[DIMENSIONS], double total_dist, 
-               obj_t* last_hit);
+obj_t* find_occluder(model_t* model, real_t base[DIMENSIONS],
+                     real_t dir[DIMENSIONS], obj_t* last_hit, real_t maxdist);
 
-obj_t* find_closest_object(list_t* scene, double base[DIMENSIONS], 
-                            double dir[DIMENSIONS], 
-                            obj_t* last_hit, double* mindist);
+obj_t* scan_occluder(store_t* scene, real_t base[DIMENSIONS],
+                     real_t dir[DIMENSIONS], obj_t* last_hit, real_t maxdist);
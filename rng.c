@@ -0,0 +1,69 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This file contains the PCG32 generator used for anti-aliasing. Each
+ * generator is keyed on the pixel, the sample index and the scene seed, so
+ * no generator state is shared between pixels or threads.
+ */
+
+/* Header file for this source file. */
+#include "rng.h"
+
+/*
+ * Scrambles a key so that neighbouring keys give unrelated results. This is
+ * the splitmix64 finalizer.
+ *
+ * Param: key  The value to scramble.
+ * Return: The scrambled value.
+ */
+uint64_t rng_mix(uint64_t key)
+{
+    key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+    return key ^ (key >> 31);
+}
+
+/*
+ * Seeds a generator for one sample of one pixel. The pixel picks the
+ * sequence and the seed and sample pick the starting point within it.
+ *
+ * Param: rng  The generator to seed.
+ * Param: seed  The seed for the whole image.
+ * Param: x  The x pixel coordinate.
+ * Param: y  The y pixel coordinate.
+ * Param: sample  The index of the sample within the pixel.
+ */
+void rng_seed(rng_t* rng, uint32_t seed, int x, int y, int sample)
+{
+    uint64_t pixel = ((uint64_t)(uint32_t)y << 32) | (uint32_t)x;
+    rng->inc = (rng_mix(pixel) << 1) | 1u;
+    rng->state = 0;
+    rng_next(rng);
+    rng->state += rng_mix(((uint64_t)seed << 32) | (uint32_t)sample);
+    rng_next(rng);
+}
+
+/*
+ * Steps a generator and returns its next output.
+ * Param: rng  The generator to step.
+ * Return: 32 uniformly distributed bits.
+ */
+uint32_t rng_next(rng_t* rng)
+{
+    uint64_t old = rng->state;
+    rng->state = old * RNG_MULT + rng->inc;
+    uint32_t shifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+    uint32_t rot = (uint32_t)(old >> 59);
+    return (shifted >> rot) | (shifted << ((-rot) & 31));
+}
+
+/*
+ * Draws a double from a generator.
+ * Param: rng  The generator to draw from.
+ * Return: A value uniformly distributed in [0, 1).
+ */
+double rng_uniform(rng_t* rng)
+{
+    return (double)rng_next(rng) * (double)RNG_UNIT;
+}
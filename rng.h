@@ -0,0 +1,41 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This is the header file for the rng.c source file. It contains a small
+ * PCG random number generator whose sequence is fixed by the pixel and
+ * sample it is seeded for, so anti-aliased images come out the same on every
+ * run and at any thread count.
+ */
+
+/* Ensures this header file is only included once. */
+#pragma once
+
+/* Included for the fixed width integer types the generator is built on. */
+#include <stdint.h>
+
+/* The multiplier of the PCG linear congruential step. */
+#define RNG_MULT 6364136223846793005ULL
+
+/* Scales a 32 bit output into [0, 1). */
+#define RNG_UNIT (1.0 / 4294967296.0)
+
+/*
+ * The state of one PCG32 generator.
+ *
+ * Data Member: state  The current position in the sequence.
+ * Data Member: inc    The odd increment selecting the sequence, one per pixel.
+ */
+typedef struct rng_type
+{
+    uint64_t state;
+    uint64_t inc;
+} rng_t;
+
+void rng_seed(rng_t* rng, uint32_t seed, int x, int y, int sample);
+
+uint32_t rng_next(rng_t* rng);
+
+double rng_uniform(rng_t* rng);
+
+uint64_t rng_mix(uint64_t key);
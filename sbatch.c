@@ -0,0 +1,484 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This file contains the batch sphere tests. A run of spheres is tested a
+ * vector at a time with the same arithmetic as hits_sphere, in the same
+ * order, so every distance comes out exactly as hits_sphere finds it. The
+ * vector kernel is compiled once per instruction set and picked at startup
+ * by sbatch_select, so one binary runs on any x86-64 processor. A single
+ * precision build has its own kernels, each twice as wide.
+ */
+
+/* Header file for this source file. */
+#include "sbatch.h"
+
+/* Keeps a multiply and the add after it from being fused into one rounding,
+ * which the AVX-512 kernels are otherwise free to do, so every kernel rounds
+ * exactly as hits_sphere does. */
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+/* Included for the SSE2, AVX2 and AVX-512 intrinsics of the kernels. */
+#include <immintrin.h>
+
+/* Marks a kernel as built for an instruction set beyond the baseline. */
+#define SBATCH_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+/*
+ * Allocates a batch. Every sphere starts out, like the padding, as one that
+ * can never be hit.
+ *
+ * Param: count  The number of spheres the batch holds.
+ * Return: The new batch.
+ */
+sbatch_t* sbatch_init(int count)
+{
+    sbatch_t* batch = Malloc(sizeof(sbatch_t));
+    size_t size = sizeof(real_t) * (size_t)(count + SBATCH_MAX_WIDTH - 1);
+    batch->center_x = Malloc(size);
+    batch->center_y = Malloc(size);
+    batch->center_z = Malloc(size);
+    batch->radius_sq = Malloc(size);
+    batch->count = count;
+    for (int i = 0; i < count + SBATCH_MAX_WIDTH - 1; i++)
+    {
+        batch->center_x[i] = 0;
+        batch->center_y[i] = 0;
+        batch->center_z[i] = 0;
+        batch->radius_sq[i] = -1;
+    }
+    return batch;
+}
+
+/*
+ * Copies a sphere into one slot of a batch.
+ *
+ * Param: batch  The batch to write to.
+ * Param: index  The slot to write.
+ * Param: sphere  The sphere to copy.
+ */
+void sbatch_set(sbatch_t* batch, int index, sphere_t* sphere)
+{
+    batch->center_x[index] = sphere->center[X];
+    batch->center_y[index] = sphere->center[Y];
+    batch->center_z[index] = sphere->center[Z];
+    batch->radius_sq[index] = sphere->radius * sphere->radius;
+}
+
+/*
+ * Tests one sphere against a ray, for processors without vector support.
+ * The parameters are those of sbatch_lanes_t.
+ */
+static int sbatch_lanes_scalar(sbatch_t* batch, int index, real_t* base,
+                               real_t* d, real_t a, real_t min_dist, real_t* t)
+{
+    real_t v[XYZ] = {base[X] - batch->center_x[index],
+                     base[Y] - batch->center_y[index],
+                     base[Z] - batch->center_z[index]};
+    real_t b = 2 * dot3(v, d);
+    real_t c = dot3(v, v) - batch->radius_sq[index];
+    real_t discrim = (b * b) - (4 * a * c);
+    if (discrim < 0)
+    {
+        return 0;
+    }
+    t[0] = ((-1 * b) - sqrt(discrim))/((2 * a));
+    return t[0] >= min_dist;
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(SINGLE_PRECISION)
+/*
+ * Tests two spheres against a ray with SSE2. The parameters are those of
+ * sbatch_lanes_t.
+ */
+SBATCH_TARGET("sse2")
+static int sbatch_lanes_sse2(sbatch_t* batch, int index, real_t* base,
+                             real_t* d, real_t a, real_t min_dist, real_t* t)
+{
+    __m128d vx = _mm_sub_pd(_mm_set1_pd(base[X]),
+                            _mm_loadu_pd(batch->center_x + index));
+    __m128d vy = _mm_sub_pd(_mm_set1_pd(base[Y]),
+                            _mm_loadu_pd(batch->center_y + index));
+    __m128d vz = _mm_sub_pd(_mm_set1_pd(base[Z]),
+                            _mm_loadu_pd(batch->center_z + index));
+    __m128d v_dot_d = _mm_add_pd(
+        _mm_add_pd(_mm_mul_pd(vx, _mm_set1_pd(d[X])),
+                   _mm_mul_pd(vy, _mm_set1_pd(d[Y]))),
+        _mm_mul_pd(vz, _mm_set1_pd(d[Z])));
+    __m128d v_dot_v = _mm_add_pd(
+        _mm_add_pd(_mm_mul_pd(vx, vx), _mm_mul_pd(vy, vy)),
+        _mm_mul_pd(vz, vz));
+    __m128d b = _mm_mul_pd(_mm_set1_pd(2), v_dot_d);
+    __m128d c = _mm_sub_pd(v_dot_v, _mm_loadu_pd(batch->radius_sq + index));
+    __m128d discrim = _mm_sub_pd(_mm_mul_pd(b, b),
+                                 _mm_mul_pd(_mm_set1_pd(4 * a), c));
+    __m128d dist = _mm_div_pd(
+        _mm_sub_pd(_mm_mul_pd(_mm_set1_pd(-1), b), _mm_sqrt_pd(discrim)),
+        _mm_set1_pd(2 * a));
+    __m128d hit = _mm_and_pd(_mm_cmpge_pd(discrim, _mm_setzero_pd()),
+                             _mm_cmpge_pd(dist, _mm_set1_pd(min_dist)));
+    _mm_storeu_pd(t, dist);
+    return _mm_movemask_pd(hit);
+}
+
+/*
+ * Tests four spheres against a ray with AVX2. The parameters are those of
+ * sbatch_lanes_t.
+ */
+SBATCH_TARGET("avx2")
+static int sbatch_lanes_avx2(sbatch_t* batch, int index, real_t* base,
+                             real_t* d, real_t a, real_t min_dist, real_t* t)
+{
+    __m256d vx = _mm256_sub_pd(_mm256_set1_pd(base[X]),
+                               _mm256_loadu_pd(batch->center_x + index));
+    __m256d vy = _mm256_sub_pd(_mm256_set1_pd(base[Y]),
+                               _mm256_loadu_pd(batch->center_y + index));
+    __m256d vz = _mm256_sub_pd(_mm256_set1_pd(base[Z]),
+                               _mm256_loadu_pd(batch->center_z + index));
+    __m256d v_dot_d = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(vx, _mm256_set1_pd(d[X])),
+                      _mm256_mul_pd(vy, _mm256_set1_pd(d[Y]))),
+        _mm256_mul_pd(vz, _mm256_set1_pd(d[Z])));
+    __m256d v_dot_v = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(vx, vx), _mm256_mul_pd(vy, vy)),
+        _mm256_mul_pd(vz, vz));
+    __m256d b = _mm256_mul_pd(_mm256_set1_pd(2), v_dot_d);
+    __m256d c = _mm256_sub_pd(v_dot_v,
+                              _mm256_loadu_pd(batch->radius_sq + index));
+    __m256d discrim = _mm256_sub_pd(_mm256_mul_pd(b, b),
+                                    _mm256_mul_pd(_mm256_set1_pd(4 * a), c));
+    __m256d dist = _mm256_div_pd(
+        _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(-1), b),
+                      _mm256_sqrt_pd(discrim)),
+        _mm256_set1_pd(2 * a));
+    __m256d hit = _mm256_and_pd(
+        _mm256_cmp_pd(discrim, _mm256_setzero_pd(), _CMP_GE_OQ),
+        _mm256_cmp_pd(dist, _mm256_set1_pd(min_dist), _CMP_GE_OQ));
+    _mm256_storeu_pd(t, dist);
+    return _mm256_movemask_pd(hit);
+}
+
+/*
+ * Tests eight spheres against a ray with AVX-512. The parameters are those
+ * of sbatch_lanes_t.
+ */
+SBATCH_TARGET("avx512f")
+static int sbatch_lanes_avx512(sbatch_t* batch, int index, real_t* base,
+                               real_t* d, real_t a, real_t min_dist,
+                               real_t* t)
+{
+    __m512d vx = _mm512_sub_pd(_mm512_set1_pd(base[X]),
+                               _mm512_loadu_pd(batch->center_x + index));
+    __m512d vy = _mm512_sub_pd(_mm512_set1_pd(base[Y]),
+                               _mm512_loadu_pd(batch->center_y + index));
+    __m512d vz = _mm512_sub_pd(_mm512_set1_pd(base[Z]),
+                               _mm512_loadu_pd(batch->center_z + index));
+    __m512d v_dot_d = _mm512_add_pd(
+        _mm512_add_pd(_mm512_mul_pd(vx, _mm512_set1_pd(d[X])),
+                      _mm512_mul_pd(vy, _mm512_set1_pd(d[Y]))),
+        _mm512_mul_pd(vz, _mm512_set1_pd(d[Z])));
+    __m512d v_dot_v = _mm512_add_pd(
+        _mm512_add_pd(_mm512_mul_pd(vx, vx), _mm512_mul_pd(vy, vy)),
+        _mm512_mul_pd(vz, vz));
+    __m512d b = _mm512_mul_pd(_mm512_set1_pd(2), v_dot_d);
+    __m512d c = _mm512_sub_pd(v_dot_v,
+                              _mm512_loadu_pd(batch->radius_sq + index));
+    __m512d discrim = _mm512_sub_pd(_mm512_mul_pd(b, b),
+                                    _mm512_mul_pd(_mm512_set1_pd(4 * a), c));
+    __m512d dist = _mm512_div_pd(
+        _mm512_sub_pd(_mm512_mul_pd(_mm512_set1_pd(-1), b),
+                      _mm512_sqrt_pd(discrim)),
+        _mm512_set1_pd(2 * a));
+    __mmask8 hit = _mm512_cmp_pd_mask(discrim, _mm512_setzero_pd(),
+                                      _CMP_GE_OQ) &
+                   _mm512_cmp_pd_mask(dist, _mm512_set1_pd(min_dist),
+                                      _CMP_GE_OQ);
+    _mm512_storeu_pd(t, dist);
+    return hit;
+}
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(SINGLE_PRECISION)
+/*
+ * Tests four spheres against a ray with SSE2, in single precision. The
+ * parameters are those of sbatch_lanes_t.
+ */
+SBATCH_TARGET("sse2")
+static int sbatch_lanes_sse2(sbatch_t* batch, int index, real_t* base,
+                             real_t* d, real_t a, real_t min_dist, real_t* t)
+{
+    __m128 vx = _mm_sub_ps(_mm_set1_ps(base[X]),
+                           _mm_loadu_ps(batch->center_x + index));
+    __m128 vy = _mm_sub_ps(_mm_set1_ps(base[Y]),
+                           _mm_loadu_ps(batch->center_y + index));
+    __m128 vz = _mm_sub_ps(_mm_set1_ps(base[Z]),
+                           _mm_loadu_ps(batch->center_z + index));
+    __m128 v_dot_d = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(vx, _mm_set1_ps(d[X])),
+                   _mm_mul_ps(vy, _mm_set1_ps(d[Y]))),
+        _mm_mul_ps(vz, _mm_set1_ps(d[Z])));
+    __m128 v_dot_v = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)),
+        _mm_mul_ps(vz, vz));
+    __m128 b = _mm_mul_ps(_mm_set1_ps(2), v_dot_d);
+    __m128 c = _mm_sub_ps(v_dot_v, _mm_loadu_ps(batch->radius_sq + index));
+    __m128 discrim = _mm_sub_ps(_mm_mul_ps(b, b),
+                                _mm_mul_ps(_mm_set1_ps(4 * a), c));
+    __m128 dist = _mm_div_ps(
+        _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(-1), b), _mm_sqrt_ps(discrim)),
+        _mm_set1_ps(2 * a));
+    __m128 hit = _mm_and_ps(_mm_cmpge_ps(discrim, _mm_setzero_ps()),
+                            _mm_cmpge_ps(dist, _mm_set1_ps(min_dist)));
+    _mm_storeu_ps(t, dist);
+    return _mm_movemask_ps(hit);
+}
+
+/*
+ * Tests eight spheres against a ray with AVX2, in single precision. The
+ * parameters are those of sbatch_lanes_t.
+ */
+SBATCH_TARGET("avx2")
+static int sbatch_lanes_avx2(sbatch_t* batch, int index, real_t* base,
+                             real_t* d, real_t a, real_t min_dist, real_t* t)
+{
+    __m256 vx = _mm256_sub_ps(_mm256_set1_ps(base[X]),
+                              _mm256_loadu_ps(batch->center_x + index));
+    __m256 vy = _mm256_sub_ps(_mm256_set1_ps(base[Y]),
+                              _mm256_loadu_ps(batch->center_y + index));
+    __m256 vz = _mm256_sub_ps(_mm256_set1_ps(base[Z]),
+                              _mm256_loadu_ps(batch->center_z + index));
+    __m256 v_dot_d = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(vx, _mm256_set1_ps(d[X])),
+                      _mm256_mul_ps(vy, _mm256_set1_ps(d[Y]))),
+        _mm256_mul_ps(vz, _mm256_set1_ps(d[Z])));
+    __m256 v_dot_v = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)),
+        _mm256_mul_ps(vz, vz));
+    __m256 b = _mm256_mul_ps(_mm256_set1_ps(2), v_dot_d);
+    __m256 c = _mm256_sub_ps(v_dot_v,
+                             _mm256_loadu_ps(batch->radius_sq + index));
+    __m256 discrim = _mm256_sub_ps(_mm256_mul_ps(b, b),
+                                   _mm256_mul_ps(_mm256_set1_ps(4 * a), c));
+    __m256 dist = _mm256_div_ps(
+        _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(-1), b),
+                      _mm256_sqrt_ps(discrim)),
+        _mm256_set1_ps(2 * a));
+    __m256 hit = _mm256_and_ps(
+        _mm256_cmp_ps(discrim, _mm256_setzero_ps(), _CMP_GE_OQ),
+        _mm256_cmp_ps(dist, _mm256_set1_ps(min_dist), _CMP_GE_OQ));
+    _mm256_storeu_ps(t, dist);
+    return _mm256_movemask_ps(hit);
+}
+
+/*
+ * Tests sixteen spheres against a ray with AVX-512, in single precision.
+ * The parameters are those of sbatch_lanes_t.
+ */
+SBATCH_TARGET("avx512f")
+static int sbatch_lanes_avx512(sbatch_t* batch, int index, real_t* base,
+                               real_t* d, real_t a, real_t min_dist,
+                               real_t* t)
+{
+    __m512 vx = _mm512_sub_ps(_mm512_set1_ps(base[X]),
+                              _mm512_loadu_ps(batch->center_x + index));
+    __m512 vy = _mm512_sub_ps(_mm512_set1_ps(base[Y]),
+                              _mm512_loadu_ps(batch->center_y + index));
+    __m512 vz = _mm512_sub_ps(_mm512_set1_ps(base[Z]),
+                              _mm512_loadu_ps(batch->center_z + index));
+    __m512 v_dot_d = _mm512_add_ps(
+        _mm512_add_ps(_mm512_mul_ps(vx, _mm512_set1_ps(d[X])),
+                      _mm512_mul_ps(vy, _mm512_set1_ps(d[Y]))),
+        _mm512_mul_ps(vz, _mm512_set1_ps(d[Z])));
+    __m512 v_dot_v = _mm512_add_ps(
+        _mm512_add_ps(_mm512_mul_ps(vx, vx), _mm512_mul_ps(vy, vy)),
+        _mm512_mul_ps(vz, vz));
+    __m512 b = _mm512_mul_ps(_mm512_set1_ps(2), v_dot_d);
+    __m512 c = _mm512_sub_ps(v_dot_v,
+                             _mm512_loadu_ps(batch->radius_sq + index));
+    __m512 discrim = _mm512_sub_ps(_mm512_mul_ps(b, b),
+                                   _mm512_mul_ps(_mm512_set1_ps(4 * a), c));
+    __m512 dist = _mm512_div_ps(
+        _mm512_sub_ps(_mm512_mul_ps(_mm512_set1_ps(-1), b),
+                      _mm512_sqrt_ps(discrim)),
+        _mm512_set1_ps(2 * a));
+    __mmask16 hit = _mm512_cmp_ps_mask(discrim, _mm512_setzero_ps(),
+                                       _CMP_GE_OQ) &
+                    _mm512_cmp_ps_mask(dist, _mm512_set1_ps(min_dist),
+                                       _CMP_GE_OQ);
+    _mm512_storeu_ps(t, dist);
+    return hit;
+}
+#endif
+
+/*
+ * The kernel of every instruction set, and the number of spheres it tests
+ * at once. Sets that can't be built for this processor family fall back on
+ * the scalar kernel, and cpu_supports never reports them.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+static sbatch_lanes_t sbatch_kernels[ISA_COUNT] =
+{
+    sbatch_lanes_scalar, sbatch_lanes_sse2, sbatch_lanes_avx2,
+    sbatch_lanes_avx512
+};
+#ifdef SINGLE_PRECISION
+static int sbatch_widths[ISA_COUNT] = {1, 4, 8, 16};
+#else
+static int sbatch_widths[ISA_COUNT] = {1, 2, 4, 8};
+#endif
+#else
+static sbatch_lanes_t sbatch_kernels[ISA_COUNT] =
+{
+    sbatch_lanes_scalar, sbatch_lanes_scalar, sbatch_lanes_scalar,
+    sbatch_lanes_scalar
+};
+static int sbatch_widths[ISA_COUNT] = {1, 1, 1, 1};
+#endif
+
+/* The kernel in use and its width, set by sbatch_select. */
+static sbatch_lanes_t sbatch_lanes = sbatch_lanes_scalar;
+static int sbatch_lane_count = 1;
+
+/*
+ * Chooses the kernel variant every batch is tested with. It must be called
+ * before any thread starts testing.
+ *
+ * Param: isa  The instruction set to use.
+ * Return: SUCCESS, or FAILURE if the processor does not support isa.
+ */
+int sbatch_select(int isa)
+{
+    if (isa < 0 || isa >= ISA_COUNT || !cpu_supports(isa))
+    {
+        return FAILURE;
+    }
+    sbatch_lanes = sbatch_kernels[isa];
+    sbatch_lane_count = sbatch_widths[isa];
+    return SUCCESS;
+}
+
+/*
+ * Finds how many spheres the selected kernel tests at once.
+ * Return: The width of the kernel.
+ */
+int sbatch_width(void)
+{
+    return sbatch_lane_count;
+}
+
+/*
+ * Finds the nearest sphere in a run of the batch that a ray hits. Ties go to
+ * the sphere in the earlier slot.
+ *
+ * Param: batch  The batch to test.
+ * Param: start  The first slot of the run.
+ * Param: end    One past the last slot of the run.
+ * Param: base   The starting point of the ray.
+ * Param: dir    The direction of the ray, which need not be a unit vector.
+ * Param: skip   A slot to leave out, or -1.
+ * Param: min_dist The distance below which hits are ignored.
+ * Param: dist   Output for the distance to the nearest hit.
+ * Param: hits   Output for the number of spheres hit.
+ *
+ * Return: The slot of the nearest sphere hit, or -1 if none are.
+ */
+int sbatch_nearest(sbatch_t* batch, int start, int end, real_t* base,
+                   real_t* dir, int skip, real_t min_dist, real_t* dist,
+                   int* hits)
+{
+    real_t d[XYZ];
+    real_t t[SBATCH_MAX_WIDTH];
+    unitvec3(dir, d);
+    real_t a = dot3(d, d);
+    int nearest = -1;
+    *hits = 0;
+    for (int i = start; i < end; i += sbatch_lane_count)
+    {
+        int mask = sbatch_lanes(batch, i, base, d, a, min_dist, t);
+        for (int j = 0; mask; j++, mask >>= 1)
+        {
+            if ((mask & 1) && i + j < end && i + j != skip)
+            {
+                (*hits)++;
+                if (nearest < 0 || t[j] < *dist)
+                {
+                    nearest = i + j;
+                    *dist = t[j];
+                }
+            }
+        }
+    }
+    return nearest;
+}
+
+/*
+ * Finds any sphere in a run of the batch that blocks a ray before maxdist,
+ * stopping after the first vector that holds one.
+ *
+ * Param: batch  The batch to test.
+ * Param: start  The first slot of the run.
+ * Param: end    One past the last slot of the run.
+ * Param: base   The starting point of the ray.
+ * Param: dir    The direction of the ray, which need not be a unit vector.
+ * Param: skip   A slot to leave out, or -1.
+ * Param: min_dist The distance below which hits are ignored.
+ * Param: maxdist The distance past which spheres no longer block the ray.
+ * Param: tests  Output for the number of spheres tested.
+ * Param: hits   Output for the number of spheres hit.
+ *
+ * Return: The slot of a blocking sphere, or -1 if none block the ray.
+ */
+int sbatch_any(sbatch_t* batch, int start, int end, real_t* base,
+               real_t* dir, int skip, real_t min_dist, real_t maxdist,
+               int* tests, int* hits)
+{
+    real_t d[XYZ];
+    real_t t[SBATCH_MAX_WIDTH];
+    unitvec3(dir, d);
+    real_t a = dot3(d, d);
+    int blocker = -1;
+    *tests = 0;
+    *hits = 0;
+    for (int i = start; i < end && blocker < 0; i += sbatch_lane_count)
+    {
+        int mask = sbatch_lanes(batch, i, base, d, a, min_dist, t);
+        for (int j = 0; j < sbatch_lane_count && i + j < end; j++)
+        {
+            if (i + j != skip)
+            {
+                (*tests)++;
+                if (mask & (1 << j))
+                {
+                    (*hits)++;
+                    if (blocker < 0 && t[j] <= maxdist)
+                    {
+                        blocker = i + j;
+                    }
+                }
+            }
+        }
+    }
+    return blocker;
+}
+
+/*
+ * Frees a batch.
+ * Param: batch  The batch to free.
+ */
+void sbatch_free(sbatch_t* batch)
+{
+    if (batch)
+    {
+        free(batch->center_x);
+        free(batch->center_y);
+        free(batch->center_z);
+        free(batch->radius_sq);
+        free(batch);
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This is the header file for the sbatch.c source file. It contains a batch
+ * of spheres stored as separate arrays of coordinates, so that several
+ * spheres can be tested against one ray at a time with vector instructions.
+ */
+
+/* Ensures this header file is only included once. */
+#pragma once
+
+/* Includes the sphere_t struct that the batch is filled from. */
+#include "sphere.h"
+
+/* Includes the instruction set numbers the kernels are built for. */
+#include "cpu.h"
+
+/* The widest vector, in spheres, that any kernel variant tests at once. */
+#ifdef SINGLE_PRECISION
+#define SBATCH_MAX_WIDTH 16
+#else
+#define SBATCH_MAX_WIDTH 8
+#endif
+
+/*
+ * A batch of spheres in structure of arrays form. Every array holds
+ * SBATCH_MAX_WIDTH - 1 spheres past count that can never be hit, so a kernel
+ * may always load a full vector.
+ *
+ * Data Member: center_x  The x coordinate of every center.
+ * Data Member: center_y  The y coordinate of every center.
+ * Data Member: center_z  The z coordinate of every center.
+ * Data Member: radius_sq  The square of every radius.
+ * Data Member: count  The number of spheres in the batch.
+ */
+typedef struct sbatch_type
+{
+    real_t* center_x;
+    real_t* center_y;
+    real_t* center_z;
+    real_t* radius_sq;
+    int count;
+} sbatch_t;
+
+/*
+ * A kernel that tests one vector of spheres against a ray.
+ *
+ * Param: batch  The batch to test.
+ * Param: index  The first slot of the vector.
+ * Param: base   The starting point of the ray.
+ * Param: d      The unit direction of the ray.
+ * Param: a      The dot product of d with itself.
+ * Param: min_dist The distance below which hits are ignored.
+ * Param: t      Output for the distance in every lane.
+ *
+ * Return: A mask with bit i set if lane i is a hit.
+ */
+typedef int (*sbatch_lanes_t)(sbatch_t* batch, int index, real_t* base,
+                              real_t* d, real_t a, real_t min_dist,
+                              real_t* t);
+
+int sbatch_select(int isa);
+
+int sbatch_width(void);
+
+sbatch_t* sbatch_init(int count);
+
+void sbatch_set(sbatch_t* batch, int index, sphere_t* sphere);
+
+int sbatch_nearest(sbatch_t* batch, int start, int end, real_t* base,
+                   real_t* dir, int skip, real_t min_dist, real_t* dist,
+                   int* hits);
+
+int sbatch_any(sbatch_t* batch, int start, int end, real_t* base,
+               real_t* dir, int skip, real_t min_dist, real_t maxdist,
+               int* tests, int* hits);
+
+void sbatch_free(sbatch_t* batch);
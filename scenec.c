@@ -0,0 +1,66 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * A compiler from text scenes to binary scenes. The text scene is loaded
+ * through the same init functions as the tracer, with every value and type
+ * they read recorded, so the binary scene holds exactly what the loader
+ * takes from the text and nothing it skips. A scene that the tracer would
+ * refuse is refused here too, and nothing is written.
+ *
+ * Usage: scenec < scene.txt > scene.bin
+ */
+
+/* Includes the model and the scene reader it is loaded through. */
+#include "model.h"
+
+/* The number of command line arguments taken. */
+#define SCENEC_ARGS 1
+
+/* The values of the projection, its world size and then its viewpoint. */
+#define SCENEC_PROJ_VALUES 5
+
+int main(int argc, char** argv)
+{
+    if (argc != SCENEC_ARGS)
+    {
+        fprintf(stderr, "Usage: %s < scene.txt > scene.bin\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    scene_in_t* in = scene_open(stdin, TRUE);
+    if (!in)
+    {
+        return EXIT_FAILURE;
+    }
+    model_t model;
+    /* The window size in pixels is not part of the scene. */
+    model.proj = projection_init(1, 1, in);
+    model.lights = store_init();
+    model.scene = store_init();
+    /* The tracer reads on past a short projection, but a binary scene
+     * written from one would not hold what the text says. */
+    int rc = in->num_values == SCENEC_PROJ_VALUES ? SUCCESS : FAILURE;
+    if (rc == SUCCESS)
+    {
+        rc = model_init(in, &model);
+    }
+    if (rc == SUCCESS)
+    {
+        rc = scene_write(stdout, in);
+    }
+    else
+    {
+        fprintf(stderr, "An error in the input file has been detected. No "
+                        "binary scene written.\n");
+    }
+    if (rc == SUCCESS)
+    {
+        fprintf(stderr, "Wrote %zu objects and %zu values.\n",
+                in->num_types, in->num_values);
+    }
+    scene_close(in);
+    free(model.proj);
+    delete_store(model.lights);
+    delete_store(model.scene);
+    return rc == SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,311 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This file contains the reader that scenes are loaded through. Text scenes
+ * are scanned a line at a time as they always have been. Binary scenes are
+ * mapped into memory and their values are handed out in order, so loading
+ * one does no parsing at all, and both build exactly the same model.
+ */
+
+/* Header file for this source file. */
+#include "scenefile.h"
+/* Included for the SUCCESS and FAILURE return codes. */
+#include "object.h"
+
+/* Included for the variable argument lists of scene_read. */
+#include <stdarg.h>
+/* Included for memcmp, used to check the magic bytes. */
+#include <string.h>
+/* Included for mapping binary scenes. */
+#include <sys/mman.h>
+/* Included for finding the size of a binary scene. */
+#include <sys/stat.h>
+/* Included for pread, used to peek at the magic bytes. */
+#include <unistd.h>
+
+/*
+ * Finds where the values of a binary scene start, after the header and the
+ * padded types.
+ *
+ * Param: num_types  The number of types in the scene.
+ *
+ * Return: The offset of the first value in bytes.
+ */
+static size_t scene_values_offset(size_t num_types)
+{
+    size_t types_size = sizeof(int32_t) * num_types;
+    types_size = (types_size + sizeof(double) - 1) & ~(sizeof(double) - 1);
+    return sizeof(scene_header_t) + types_size;
+}
+
+/*
+ * Maps a binary scene and checks that its header can be trusted.
+ *
+ * Param: scene  The reader to set up.
+ * Param: fd     The file the scene is in.
+ * Param: size   The size of the file in bytes.
+ *
+ * Return: SUCCESS or FAILURE.
+ */
+static int scene_map(scene_in_t* scene, int fd, size_t size)
+{
+    void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+    {
+        perror("mmap");
+        return FAILURE;
+    }
+    /* The values are read once from front to back. */
+    madvise(map, size, MADV_SEQUENTIAL);
+    scene->map = map;
+    scene->map_size = size;
+    scene_header_t* header = (scene_header_t*)map;
+    if (header->version != SCENE_VERSION)
+    {
+        fprintf(stderr, "Binary scene is version %u, but only version %d "
+                        "can be read.\n", header->version, SCENE_VERSION);
+        return FAILURE;
+    }
+    if (header->byte_order != SCENE_BYTE_ORDER)
+    {
+        fprintf(stderr, "Binary scene was written with the other byte "
+                        "order.\n");
+        return FAILURE;
+    }
+    size_t offset = scene_values_offset(header->num_types);
+    if (offset > size ||
+        header->num_values > (size - offset) / sizeof(double))
+    {
+        fprintf(stderr, "Binary scene is shorter than its header says.\n");
+        return FAILURE;
+    }
+    scene->types = (int32_t*)((char*)map + sizeof(scene_header_t));
+    scene->values = (double*)((char*)map + offset);
+    scene->num_types = header->num_types;
+    scene->num_values = (size_t)header->num_values;
+    return SUCCESS;
+}
+
+/*
+ * Opens a scene for reading. A binary scene is recognized by its magic bytes
+ * and mapped, which needs it to be a regular file, such as one redirected to
+ * stdin. Anything else is read as text.
+ *
+ * Param: in      The stream the scene is read from.
+ * Param: record  TRUE to record a text scene as it is read, so it can be
+ *                written out with scene_write. Binary scenes are never
+ *                recorded.
+ *
+ * Return: The reader, or NULL if a binary scene could not be loaded.
+ */
+scene_in_t* scene_open(FILE* in, int record)
+{
+    scene_in_t* scene = Malloc(sizeof(scene_in_t));
+    scene->text = in;
+    scene->map = NULL;
+    scene->map_size = 0;
+    scene->types = NULL;
+    scene->values = NULL;
+    scene->num_types = 0;
+    scene->num_values = 0;
+    scene->type_capacity = 0;
+    scene->value_capacity = 0;
+    scene->next_type = 0;
+    scene->next_value = 0;
+    scene->record = record;
+    int fd = fileno(in);
+    struct stat info;
+    char magic[SCENE_MAGIC_SIZE];
+    if (fd < 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        /* A stream can't be mapped, but the first byte can be peeked at to
+         * keep a piped binary scene from being read as text. */
+        int first = getc(in);
+        ungetc(first, in);
+        if (first == SCENE_MAGIC[0])
+        {
+            fprintf(stderr, "Binary scenes must be redirected from a file "
+                            "so they can be mapped.\n");
+            scene_close(scene);
+            return NULL;
+        }
+        return scene;
+    }
+    if (record || (size_t)info.st_size < sizeof(scene_header_t) ||
+        pread(fd, magic, SCENE_MAGIC_SIZE, 0) != SCENE_MAGIC_SIZE ||
+        memcmp(magic, SCENE_MAGIC, SCENE_MAGIC_SIZE) != 0)
+    {
+        return scene;
+    }
+    scene->text = NULL;
+    scene->record = FALSE;
+    if (scene_map(scene, fd, (size_t)info.st_size) != SUCCESS)
+    {
+        scene_close(scene);
+        return NULL;
+    }
+    return scene;
+}
+
+/*
+ * Adds a value to the recording of a text scene.
+ *
+ * Param: scene  The reader being recorded.
+ * Param: value  The value that was read.
+ */
+static void scene_record_value(scene_in_t* scene, double value)
+{
+    if (scene->num_values == scene->value_capacity)
+    {
+        scene->value_capacity = scene->value_capacity ?
+                                scene->value_capacity * 2 : SCENE_INITIAL;
+        scene->values = Realloc(scene->values,
+                                sizeof(double) * scene->value_capacity);
+    }
+    scene->values[scene->num_values++] = value;
+}
+
+/*
+ * Reads the values of one line of a scene into real_t variables, the way
+ * one fscanf call and the fgets after it used to. In a text scene anything
+ * after the values on the line is skipped as a comment.
+ *
+ * Param: scene  The scene to read from.
+ * Param: count  The number of values to read.
+ * Param: ...    A real_t pointer for each value.
+ *
+ * Return: The number of values read, which is less than count if the scene
+ *         ran out or a value could not be read.
+ */
+int scene_read(scene_in_t* scene, int count, ...)
+{
+    va_list args;
+    int read = 0;
+    va_start(args, count);
+    if (scene->text)
+    {
+        char buff[BUFF_SIZE];
+        while (read < count &&
+               fscanf(scene->text, SCN_REAL, va_arg(args, real_t*)) == 1)
+        {
+            read++;
+        }
+        fgets(buff, BUFF_SIZE, scene->text);
+    }
+    else
+    {
+        while (read < count && scene->next_value < scene->num_values)
+        {
+            *va_arg(args, real_t*) =
+                (real_t)scene->values[scene->next_value++];
+            read++;
+        }
+    }
+    va_end(args);
+    if (scene->record)
+    {
+        va_start(args, count);
+        for (int i = 0; i < read; i++)
+        {
+            scene_record_value(scene, *va_arg(args, real_t*));
+        }
+        va_end(args);
+    }
+    return read;
+}
+
+/*
+ * Reads the type of the next object in a scene.
+ *
+ * Param: scene    The scene to read from.
+ * Param: objtype  Output for the type.
+ *
+ * Return: FALSE once the scene has no more objects, otherwise TRUE.
+ */
+int scene_read_type(scene_in_t* scene, int* objtype)
+{
+    if (!scene->text)
+    {
+        if (scene->next_type == scene->num_types)
+        {
+            return FALSE;
+        }
+        *objtype = scene->types[scene->next_type++];
+        return TRUE;
+    }
+    char buff[BUFF_SIZE];
+    if (fscanf(scene->text, " %d", objtype) == EOF)
+    {
+        return FALSE;
+    }
+    fgets(buff, BUFF_SIZE, scene->text);
+    if (scene->record)
+    {
+        if (scene->num_types == scene->type_capacity)
+        {
+            scene->type_capacity = scene->type_capacity ?
+                                   scene->type_capacity * 2 : SCENE_INITIAL;
+            scene->types = Realloc(scene->types,
+                                   sizeof(int32_t) * scene->type_capacity);
+        }
+        scene->types[scene->num_types++] = *objtype;
+    }
+    return TRUE;
+}
+
+/*
+ * Writes everything recorded from a text scene as a binary scene.
+ *
+ * Param: out    The stream to write to.
+ * Param: scene  The recorded scene.
+ *
+ * Return: SUCCESS or FAILURE.
+ */
+int scene_write(FILE* out, scene_in_t* scene)
+{
+    scene_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SCENE_MAGIC, SCENE_MAGIC_SIZE);
+    header.version = SCENE_VERSION;
+    header.byte_order = SCENE_BYTE_ORDER;
+    header.num_types = (uint32_t)scene->num_types;
+    header.num_values = scene->num_values;
+    char padding[sizeof(double)] = {0};
+    size_t pad = scene_values_offset(scene->num_types) -
+                 sizeof(scene_header_t) - sizeof(int32_t) * scene->num_types;
+    if (fwrite(&header, sizeof(header), 1, out) != 1 ||
+        fwrite(scene->types, sizeof(int32_t), scene->num_types, out) !=
+        scene->num_types ||
+        fwrite(padding, 1, pad, out) != pad ||
+        fwrite(scene->values, sizeof(double), scene->num_values, out) !=
+        scene->num_values)
+    {
+        perror("fwrite");
+        return FAILURE;
+    }
+    return SUCCESS;
+}
+
+/*
+ * Closes a scene reader. The stream it was opened on is left open.
+ *
+ * Param: scene  The reader to close, which may be NULL.
+ */
+void scene_close(scene_in_t* scene)
+{
+    if (!scene)
+    {
+        return;
+    }
+    if (scene->map)
+    {
+        munmap(scene->map, scene->map_size);
+    }
+    else
+    {
+        free(scene->types);
+        free(scene->values);
+    }
+    free(scene);
+}
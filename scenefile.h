@@ -0,0 +1,100 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This is the header file for the scenefile.c source file. It contains the
+ * reader that every init function takes its numbers from, which reads either
+ * the text scene format or the binary one, and the layout of binary scenes.
+ */
+
+/* Ensures this header file is only included once. */
+#pragma once
+
+/* Included for real_t, Malloc and the FILE type. */
+#include "utils.h"
+
+/* Included for the fixed width integer types binary scenes are made of. */
+#include <stdint.h>
+
+/* The bytes every binary scene starts with. */
+#define SCENE_MAGIC "RAYSCENE"
+#define SCENE_MAGIC_SIZE 8
+
+/* The version of the binary layout written by this tracer. A loader only
+ * accepts the version it was built for. */
+#define SCENE_VERSION 1
+
+/* Written in the native byte order, so a scene from a machine of the other
+ * order is turned away instead of being read as garbage. */
+#define SCENE_BYTE_ORDER 0x01020304u
+
+/* The number of values or types recorded before the arrays first grow. */
+#define SCENE_INITIAL 256
+
+/*
+ * The header at the start of a binary scene. It is followed by num_types
+ * object types as int32_t, padded to a multiple of 8 bytes, and then by
+ * num_values values as doubles. The values are the numbers of the text
+ * scene in the order the init functions read them, starting with the
+ * projection, and the types are the object types that come between them.
+ *
+ * Data Member: magic       SCENE_MAGIC, without a terminator.
+ * Data Member: version     SCENE_VERSION.
+ * Data Member: byte_order  SCENE_BYTE_ORDER.
+ * Data Member: num_types   The number of objects in the scene.
+ * Data Member: reserved    Zero, keeping num_values aligned.
+ * Data Member: num_values  The number of values in the scene.
+ */
+typedef struct scene_header_type
+{
+    char magic[SCENE_MAGIC_SIZE];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t num_types;
+    uint32_t reserved;
+    uint64_t num_values;
+} scene_header_t;
+
+/*
+ * A scene being read, from text or from a mapped binary scene. A text scene
+ * may also be recorded as it is read, so it can be written back out as a
+ * binary scene.
+ *
+ * Data Member: text      The text being read, or NULL for a binary scene.
+ * Data Member: map       The mapped binary scene, or NULL for text.
+ * Data Member: map_size  The size of the mapping in bytes.
+ * Data Member: types     The object types, in the mapping or recorded.
+ * Data Member: values    The values, in the mapping or recorded.
+ * Data Member: num_types   The number of entries in types.
+ * Data Member: num_values  The number of entries in values.
+ * Data Member: type_capacity   The room in types while recording.
+ * Data Member: value_capacity  The room in values while recording.
+ * Data Member: next_type   The next type a binary scene will give.
+ * Data Member: next_value  The next value a binary scene will give.
+ * Data Member: record  Set when a text scene is recorded as it is read.
+ */
+typedef struct scene_in_type
+{
+    FILE* text;
+    void* map;
+    size_t map_size;
+    int32_t* types;
+    double* values;
+    size_t num_types;
+    size_t num_values;
+    size_t type_capacity;
+    size_t value_capacity;
+    size_t next_type;
+    size_t next_value;
+    int record;
+} scene_in_t;
+
+scene_in_t* scene_open(FILE* in, int record);
+
+int scene_read(scene_in_t* in, int count, ...);
+
+int scene_read_type(scene_in_t* in, int* objtype);
+
+int scene_write(FILE* out, scene_in_t* in);
+
+void scene_close(scene_in_t* in);
@@ -18,20 +18,15 @@
  *
  * Return: obj  The object that has been constructed and initialized.
  */
-obj_t* sphere_init(FILE* in, int objtype)
+obj_t* sphere_init(scene_in_t* in, int objtype)
 {
-    char buff[BUFF_SIZE];
     obj_t* obj    = NULL;
     int pcount    = 0;
     obj = object_init(in, objtype);
     sphere_t* sphere = Malloc(sizeof(sphere_t));
-    pcount += fscanf(in, "%lf %lf %lf", 
-                     &sphere->center[X],
-                    &sphere->center[Y],
-                    &sphere->center[Z]);
-    fgets(buff, BUFF_SIZE, in);
-    pcount += fscanf(in, "%lf", &sphere->radius);
-    fgets(buff, BUFF_SIZE, in);
+    pcount += scene_read(in, 3, &sphere->center[X], &sphere->center[Y],
+                         &sphere->center[Z]);
+    pcount += scene_read(in, 1, &sphere->radius);
     if (sphere->radius < 0 || pcount != SPHERE_OBJS || obj == NULL)
     {
         fprintf(stderr, "Error found in sphere_init...");
@@ -41,6 +36,7 @@ obj_t* sphere_init(FILE* in, int objtype)
     {
         obj->priv = (void*)sphere;
         obj->hits = hits_sphere;//
+        obj->cold->surface = surface_sphere;
     }
     return obj;
 }
@@ -54,44 +50,63 @@ obj_t* sphere_init(FILE* in, int objtype)
  *
  * Return: t_sub_h The calculated distance to the object, or -1 if we miss.
  */
-double hits_sphere(double *base, double *dir, obj_t *obj)
+real_t hits_sphere(real_t *base, real_t *dir, obj_t *obj)
 { 
-    obj->hitloc[X] = FP_NAN;
-    obj->hitloc[Y] = FP_NAN;
-    obj->hitloc[Z] = FP_NAN;
-    obj->normal[X] = FP_NAN;
-    obj->normal[Y] = FP_NAN;
-    obj->normal[Z] = FP_NAN;
-    double t_sub_h = MISS;
+    real_t t_sub_h = MISS;
     sphere_t* sphere = (sphere_t*)obj->priv;
-    double* d = Malloc(sizeof(double) * DIMENSIONS);
-    unitvec3(dir, d);
-    double a = dot3(d, d);
-    double* vprime = Malloc(sizeof(double) * DIMENSIONS);
-    diff3(sphere->center, base, vprime);
+    vec3_t d = vec3_unit(vec3_load(dir));
+    real_t a = vec3_dot(d, d);
+    vec3_t vprime = vec3_sub(vec3_load(base), vec3_load(sphere->center));
     /* Here we have a few magic numbers for the quadratic formula.*/
-    double b = 2 * dot3(vprime, d);
-    double c = dot3(vprime, vprime) - sphere->radius * sphere->radius;
-    double discrim = (b * b) - (4 * a * c);
-    free(vprime);
+    real_t b = 2 * vec3_dot(vprime, d);
+    real_t c = vec3_dot(vprime, vprime) - sphere->radius * sphere->radius;
+    real_t discrim = (b * b) - (4 * a * c);
     if(discrim >= 0)
     {
-        double* scaled_d = Malloc(sizeof(double) * DIMENSIONS);
         t_sub_h = ((-1 * b) - sqrt(discrim))/((2 * a));
-        scale3(t_sub_h, d, scaled_d);
-        sum3(base, scaled_d, obj->hitloc);
-        
-        double* hitloc_center = Malloc(sizeof(double) * DIMENSIONS);
-        diff3(sphere->center, obj->hitloc, hitloc_center);
-        unitvec3(hitloc_center, obj->normal);
-        
-        free(hitloc_center);
-        free(scaled_d);
     }
-    free(d);
     return t_sub_h;
 }
 
+/*
+ * Function for finding the hit location and normal on a sphere.
+ *
+ * Param: base  The starting point for the ray.
+ * Param: dir   The direction of the approaching ray.
+ * Param: t     The distance returned by hits_sphere.
+ * Param: obj   The sphere object that was hit.
+ * Param: hit   Output for the hit location and normal.
+ */
+void surface_sphere(real_t* base, real_t* dir, real_t t, obj_t* obj,
+                    hit_t* hit)
+{
+    sphere_t* sphere = (sphere_t*)obj->priv;
+    vec3_t d = vec3_unit(vec3_load(dir));
+    vec3_t hitloc = vec3_along(vec3_load(base), d, t);
+    vec3_store(hitloc, hit->hitloc);
+    vec3_store(vec3_unit(vec3_sub(hitloc, vec3_load(sphere->center))),
+               hit->normal);
+}
+
+/*
+ * Function for finding the world space bounds of a sphere.
+ *
+ * Param: obj  The sphere object to bound.
+ * Param: box  The output box.
+ *
+ * Return: BOUNDED, since spheres are always finite.
+ */
+int sphere_bounds(obj_t* obj, bbox_t* box)
+{
+    sphere_t* sphere = (sphere_t*)obj->priv;
+    for (int i = 0; i < XYZ; i++)
+    {
+        box->min[i] = sphere->center[i] - sphere->radius;
+        box->max[i] = sphere->center[i] + sphere->radius;
+    }
+    return BOUNDED;
+}
+
 /*
  * Function for dumping the data of a sphere.
  * Param: out  The output stream to dump to.
@@ -13,6 +13,9 @@
 
 #include "veclib.h"
 
+/* Includes the bbox_t struct for reporting bounds. */
+#include "bbox.h"
+
 /* Contains the object_type struct. */
 #include "object.h"
 
@@ -28,13 +31,18 @@
  */
 typedef struct sphere
 {
-    double center[DIMENSIONS];
-    double radius;
+    real_t center[DIMENSIONS];
+    real_t radius;
 } sphere_t;
 
-obj_t* sphere_init(FILE* in, int objtype);
+obj_t* sphere_init(scene_in_t* in, int objtype);
+
+real_t hits_sphere(real_t* base, real_t* dir, obj_t* obj);
+
+void surface_sphere(real_t* base, real_t* dir, real_t t, obj_t* obj,
+                    hit_t* hit);
 
-double hits_sphere(double* base, double* dir, obj_t* obj);
+int sphere_bounds(obj_t* obj, bbox_t* box);
 
 void dump_sphere(FILE* out, obj_t* obj);
 
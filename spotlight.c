@@ -13,9 +13,8 @@
  * Param: in  The stream to read in frome.
  * Param: objtype  The number of the type of object that we are reading in.
  */
-obj_t* spotlight_init(FILE* in, int objtype)
+obj_t* spotlight_init(scene_in_t* in, int objtype)
 {
-    char buff[BUFF_SIZE];
     obj_t* obj = NULL;
     light_t* light = NULL;
     spotlight_t* spot = NULL;
@@ -26,18 +25,16 @@ obj_t* spotlight_init(FILE* in, int objtype)
         light = (light_t*)obj->priv;
         spot = Malloc(sizeof(spotlight_t));
         light->priv = (void*)spot;
-        pcount += fscanf(in, "%lf %lf %lf",
-                         &spot->direction[X],
-                         &spot->direction[Y],
-                         &spot->direction[Z]);
-        fgets(buff, BUFF_SIZE, in);
-        pcount += fscanf(in, "%lf", &spot->theta);
-        fgets(buff, BUFF_SIZE, in);
+        pcount += scene_read(in, 3, &spot->direction[X], &spot->direction[Y],
+                             &spot->direction[Z]);
+        pcount += scene_read(in, 1, &spot->theta);
         if (pcount == SPOTLIGHT_OBJS)
         {
             spot->costheta = cos(spot->theta * M_PI / HALF_CIRCLE);
             light->illum_check = spotlight_check;
+            light->reach_check = spotlight_reaches;
             diff3(light->location, spot->direction, spot->direction);
+            vec3_store(vec3_unit(vec3_load(spot->direction)), spot->unit_dir);
         }
         else
         {
@@ -49,21 +46,51 @@ obj_t* spotlight_init(FILE* in, int objtype)
 }
 
 /*
- * Function for checking if an object is illuminated by this object.
+ * Function for checking if an object is illuminated by this object. It is
+ * cheap enough to be run before the shadow ray is traced.
  * Param: lobj  The spotlight we are checking.
- * Param: hitloc  The hit location on the object that we are checking.
+ * Param: to_hit  The unit vector from the spotlight to the hit location on
+ *                the object that we are checking.
  * Return: 0 if miss, otherwise some value greater than 0.
  */
-int spotlight_check(obj_t* lobj, double* hitloc)
+int spotlight_check(obj_t* lobj, real_t* to_hit)
 {
     light_t* light = (light_t*)lobj->priv;
     spotlight_t* spot = (spotlight_t*)light->priv;
-    double adjust_hitloc[XYZ];
-    double unit_dir[XYZ];
-    diff3(light->location, hitloc, adjust_hitloc);
-    unitvec3(adjust_hitloc, adjust_hitloc);
-    unitvec3(spot->direction, unit_dir);
-    return (dot3(adjust_hitloc, unit_dir) > spot->costheta);
+    return (vec3_dot(vec3_load(to_hit), vec3_load(spot->unit_dir)) >
+            spot->costheta);
+}
+
+/*
+ * Function for checking if any point of a box could be illuminated by this
+ * object. The box is replaced by the sphere around it, which reaches into
+ * the cone if the angle from the centerline to its center is no more than
+ * the cone's half-width plus the half-width the sphere covers as seen from
+ * the spotlight.
+ * Param: lobj  The spotlight we are checking.
+ * Param: box  The bounds of the object that we are checking.
+ * Return: 0 if no point of the box is lit, otherwise 1.
+ */
+int spotlight_reaches(obj_t* lobj, bbox_t* box)
+{
+    light_t* light = (light_t*)lobj->priv;
+    spotlight_t* spot = (spotlight_t*)light->priv;
+    vec3_t low = vec3_load(box->min);
+    vec3_t high = vec3_load(box->max);
+    vec3_t to_center = vec3_sub(vec3_scale(vec3_add(low, high), 0.5),
+                                vec3_load(light->location));
+    real_t radius = vec3_length(vec3_sub(high, low)) * 0.5;
+    real_t dist = vec3_length(to_center);
+    if (dist <= radius)
+    {
+        return 1;
+    }
+    real_t cosine = vec3_dot(vec3_scale(to_center, 1 / dist),
+                             vec3_load(spot->unit_dir));
+    real_t spread = acos(cosine > 1 ? 1 : cosine < -1 ? -1 : cosine);
+    real_t reach = spot->theta * (real_t)M_PI / HALF_CIRCLE +
+                   asin(radius / dist);
+    return spread <= reach + SPOT_MARGIN;
 }
 
 /*
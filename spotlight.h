@@ -18,24 +18,31 @@
 #define SPOTLIGHT_OBJS 4
 /* 180 degrees, or half a circle. */
 #define HALF_CIRCLE 180
+/* The angle, in radians, that the cone is widened by when checked against a
+ * box, so that rounding can't shut out a box it does reach. */
+#define SPOT_MARGIN 1e-4
 /* 
  * Struct defining a spotlight object.
  * 
  * Data Member: direction  Cone centerline vector.
+ * Data Member: unit_dir   precomputed unit vector along direction
  * Data Member: theta      Half-width of cone in deg
  * Data Member: costheta   precomputed cos(theta)
  */
 typedef struct spotlight_type
 {
-    double direction[XYZ];
-    double theta;
-    double costheta;
+    real_t direction[XYZ];
+    real_t unit_dir[XYZ];
+    real_t theta;
+    real_t costheta;
 } spotlight_t;
 
-obj_t* spotlight_init(FILE* in, int objtype);
+obj_t* spotlight_init(scene_in_t* in, int objtype);
 
 void dump_spotlight(FILE* out, obj_t* obj);
 
-int spotlight_check(obj_t* lobj, double* hitloc);
+int spotlight_check(obj_t* lobj, real_t* to_hit);
+
+int spotlight_reaches(obj_t* lobj, bbox_t* box);
 
 void kill_spotlight(void* spotlight);
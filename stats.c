@@ -0,0 +1,149 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This file contains the statistics mode. Counters are kept per thread so
+ * the render threads never contend for them, and are merged into a single
+ * set of totals that is reported as JSON at the end of a run.
+ */
+
+/* Header file for this source file. */
+#include "stats.h"
+
+/* Set when statistics are being collected. */
+int stats_enabled = FALSE;
+
+/* The counters of the current thread. */
+__thread stats_t thread_stats;
+
+/* The counters merged from every thread so far. */
+static stats_t totals;
+
+/* Guards totals. */
+static pthread_mutex_t totals_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* The names used in the report for each object type. */
+static const char* type_names[STAT_TYPES] =
+{
+    "light", "spotlight", "projector", "sphere", "plane", "finite_plane",
+    "tiled_plane", "tex_plane", "ref_sphere", "p_sphere", "p_plane",
+    "paraboloid", "cylinder", "cone", "hyperboloid"
+};
+
+/* The names used in the report for each phase. */
+static const char* phase_names[PHASES] =
+{
+    "load", "build", "render", "write", "cleanup"
+};
+
+/*
+ * Adds the current thread's counters to the totals and clears them. Called
+ * by every thread once it has finished rendering.
+ */
+void stats_flush(void)
+{
+    if (!stats_enabled)
+    {
+        return;
+    }
+    pthread_mutex_lock(&totals_lock);
+    for (int i = 0; i < RAY_KINDS; i++)
+    {
+        totals.rays[i] += thread_stats.rays[i];
+    }
+    for (int i = 0; i < STAT_TYPES; i++)
+    {
+        totals.tests[i] += thread_stats.tests[i];
+        totals.hits[i] += thread_stats.hits[i];
+    }
+    totals.box_tests += thread_stats.box_tests;
+    pthread_mutex_unlock(&totals_lock);
+    memset(&thread_stats, 0, sizeof(stats_t));
+}
+
+/*
+ * Reads a monotonic clock.
+ * Return: The current time in seconds.
+ */
+double stats_clock(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / (double)1e9;
+}
+
+/*
+ * Adds the time since start to a phase.
+ *
+ * Param: phase  The phase to add to.
+ * Param: start  The time the phase began, from stats_clock.
+ */
+void stats_phase(int phase, double start)
+{
+    double elapsed = stats_clock() - start;
+    pthread_mutex_lock(&totals_lock);
+    totals.phases[phase] += elapsed;
+    pthread_mutex_unlock(&totals_lock);
+}
+
+/*
+ * Records the allocations made while rendering, which should be none.
+ *
+ * Param: count  The number of allocations.
+ */
+void stats_allocations(unsigned long count)
+{
+    pthread_mutex_lock(&totals_lock);
+    totals.render_allocs += count;
+    pthread_mutex_unlock(&totals_lock);
+}
+
+/*
+ * Writes the merged totals as a JSON object. The average reflection depth is
+ * the number of reflection rays per primary ray, since every ray reflects
+ * into at most one more.
+ *
+ * Param: out  The stream to write to.
+ * Param: width  The image width in pixels.
+ * Param: height  The image height in pixels.
+ * Param: threads  The number of threads rendered with.
+ * Param: isa  The name of the instruction set the vector kernels ran with.
+ */
+void stats_report(FILE* out, int width, int height, int threads,
+                  char* isa)
+{
+    unsigned long primary = totals.rays[RAY_PRIMARY];
+    double depth = primary ? (double)totals.rays[RAY_REFLECTION] /
+                             (double)primary : 0;
+    fprintf(out, "{\n  \"width\": %d,\n  \"height\": %d,\n"
+                 "  \"threads\": %d,\n  \"isa\": \"%s\",\n"
+                 "  \"precision\": \"%s\",\n", width, height, threads, isa,
+                 REAL_NAME);
+    fprintf(out, "  \"rays\": {\"primary\": %lu, \"reflection\": %lu, "
+                 "\"shadow\": %lu},\n", primary,
+                 totals.rays[RAY_REFLECTION], totals.rays[RAY_SHADOW]);
+    fprintf(out, "  \"average_reflection_depth\": %.6f,\n", depth);
+    fprintf(out, "  \"box_tests\": %lu,\n", totals.box_tests);
+    fprintf(out, "  \"render_allocations\": %lu,\n", totals.render_allocs);
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    fprintf(out, "  \"peak_rss_kb\": %ld,\n", usage.ru_maxrss);
+    fprintf(out, "  \"objects\": {");
+    const char* sep = "";
+    for (int i = 0; i < STAT_TYPES; i++)
+    {
+        if (totals.tests[i])
+        {
+            fprintf(out, "%s\n    \"%s\": {\"tests\": %lu, \"hits\": %lu}",
+                    sep, type_names[i], totals.tests[i], totals.hits[i]);
+            sep = ",";
+        }
+    }
+    fprintf(out, "\n  },\n  \"phases\": {");
+    for (int i = 0; i < PHASES; i++)
+    {
+        fprintf(out, "%s\"%s\": %.6f", i ? ", " : "", phase_names[i],
+                totals.phases[i]);
+    }
+    fprintf(out, "}\n}\n");
+}
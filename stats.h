@@ -0,0 +1,111 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This is the header file for the stats.c source file. It contains the
+ * counters kept in statistics mode. Every thread counts into its own copy,
+ * which is merged into the totals when the thread finishes its work.
+ */
+
+/* Ensures this header file is only included once. */
+#pragma once
+
+/* Included for the lock that guards the merged totals. */
+#include <pthread.h>
+
+/* Included for clock_gettime, used to time each phase. */
+#include <time.h>
+
+/* Included for memset, used to clear a thread's counters. */
+#include <string.h>
+
+/* Included for getrusage, used to report the peak resident set size. */
+#include <sys/resource.h>
+
+/* Includes the object type enumeration and stdio. */
+#include "utils.h"
+
+/* The kinds of rays that are counted. */
+#define RAY_PRIMARY    0
+#define RAY_REFLECTION 1
+#define RAY_SHADOW     2
+#define RAY_KINDS      3
+
+/* The phases of a run that are timed. */
+#define PHASE_LOAD    0
+#define PHASE_BUILD   1
+#define PHASE_RENDER  2
+#define PHASE_WRITE   3
+#define PHASE_CLEANUP 4
+#define PHASES        5
+
+/* The number of object types that tests are counted for. */
+#define STAT_TYPES (LAST_TYPE - FIRST_TYPE)
+
+/* Counts one ray of a kind on the current thread. */
+#define STAT_RAY(kind) \
+    do { if (stats_enabled) thread_stats.rays[kind]++; } while (0)
+
+/* Counts one intersection test against an object type, and a hit if hit is
+ * true. */
+#define STAT_TEST(type, hit) \
+    do \
+    { \
+        if (stats_enabled) \
+        { \
+            thread_stats.tests[(type) - FIRST_TYPE]++; \
+            if (hit) thread_stats.hits[(type) - FIRST_TYPE]++; \
+        } \
+    } while (0)
+
+/* Counts a number of tests against an object type, of which hits hit. */
+#define STAT_TESTS(type, count, hit) \
+    do \
+    { \
+        if (stats_enabled) \
+        { \
+            thread_stats.tests[(type) - FIRST_TYPE] += (unsigned long)(count); \
+            thread_stats.hits[(type) - FIRST_TYPE] += (unsigned long)(hit); \
+        } \
+    } while (0)
+
+/* Counts one ray against box test on the current thread. */
+#define STAT_BOX() \
+    do { if (stats_enabled) thread_stats.box_tests++; } while (0)
+
+/*
+ * A set of counters, either for one thread or merged for the whole run.
+ *
+ * Data Member: rays  The number of rays traced of each kind.
+ * Data Member: tests  The number of hits_* calls for each object type.
+ * Data Member: hits  The number of those calls that found a hit.
+ * Data Member: box_tests  The number of hierarchy boxes tested.
+ * Data Member: phases  The seconds spent in each phase of the run.
+ * Data Member: render_allocs  The allocations made while rendering.
+ */
+typedef struct stats_type
+{
+    unsigned long rays[RAY_KINDS];
+    unsigned long tests[STAT_TYPES];
+    unsigned long hits[STAT_TYPES];
+    unsigned long box_tests;
+    double phases[PHASES];
+    unsigned long render_allocs;
+} stats_t;
+
+/* Set when statistics are being collected. */
+extern int stats_enabled;
+
+/* The counters of the current thread. */
+extern __thread stats_t thread_stats;
+
+void stats_flush(void);
+
+double stats_clock(void);
+
+void stats_phase(int phase, double start);
+
+void stats_allocations(unsigned long count);
+
+void stats_report(FILE* out, int width, int height, int threads,
+                  char* isa);
@@ -0,0 +1,235 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * An implementation of an object store, which keeps the objects of a model
+ * in one growing array rather than linking them through the heap. Objects
+ * may only be added at the end while the model is read. Once it has been
+ * read, store_finish groups the objects by type and indexes them by id,
+ * after which the objects never move until the store is decomposed.
+ */
+
+/* This file includes utils.c for the Malloc wrapper, in addition to the
+ * function prototypes for the functions in this file. */
+#include "store.h"
+
+/*
+ * A function that initializes an empty store.
+ *
+ * Return: store  The store that was just initialized.
+ */
+store_t* store_init(void)
+{
+    store_t* store = Malloc(sizeof(store_t));
+    store->objs = NULL;
+    store->colds = NULL;
+    store->count = 0;
+    store->capacity = 0;
+    for (int i = 0; i <= STORE_TYPES; i++)
+    {
+        store->first[i] = 0;
+    }
+    store->index = NULL;
+    store->first_id = 0;
+    store->span = 0;
+    return store;
+}
+
+/*
+ * A function for adding an object to the end of a store. Both halves of the
+ * object are copied into the store's arrays and the originals are freed, so
+ * only the returned record may be used from then on. Since the arrays may
+ * move as they grow, the record is only good until the next object is added.
+ *
+ * Param: store  The store to add an object to.
+ * Param: obj    The new object, as returned by its init function.
+ *
+ * Return: The object's record in the store.
+ */
+obj_t* store_add(store_t* store, obj_t* obj)
+{
+    if (store->count == store->capacity)
+    {
+        store->capacity = store->capacity ? store->capacity * 2
+                                          : STORE_INITIAL;
+        store->objs = Realloc(store->objs,
+                              sizeof(obj_t) * (size_t)store->capacity);
+        store->colds = Realloc(store->colds,
+                               sizeof(obj_cold_t) * (size_t)store->capacity);
+        /* Points the records already added at where their halves moved. */
+        for (int i = 0; i < store->count; i++)
+        {
+            store->objs[i].cold = &store->colds[i];
+        }
+    }
+    obj_t* record = &store->objs[store->count];
+    *record = *obj;
+    store->colds[store->count] = *obj->cold;
+    record->cold = &store->colds[store->count];
+    free(obj->cold);
+    free(obj);
+    store->count++;
+    return record;
+}
+
+/*
+ * Orders two objects by type, and by the order they were read within a
+ * type. Object ids only ever grow, so the sort keeps every group in the
+ * order its objects were read.
+ *
+ * Param: a  The first object.
+ * Param: b  The second object.
+ *
+ * Return: Negative, zero or positive as a sorts before, with or after b.
+ */
+static int store_compare(const void* a, const void* b)
+{
+    const obj_t* left = a;
+    const obj_t* right = b;
+    if (left->objtype != right->objtype)
+    {
+        return left->objtype - right->objtype;
+    }
+    return left->objid - right->objid;
+}
+
+/*
+ * A function for finishing a store once every object has been added. It
+ * groups the objects by type, moves each cold half to the same slot as its
+ * object, finds where each group starts, and builds the index from object
+ * ids to slots.
+ *
+ * Param: store  The store to finish.
+ */
+void store_finish(store_t* store)
+{
+    qsort(store->objs, (size_t)store->count, sizeof(obj_t), store_compare);
+    if (store->count > 0)
+    {
+        obj_cold_t* colds = Malloc(sizeof(obj_cold_t) *
+                                   (size_t)store->capacity);
+        for (int i = 0; i < store->count; i++)
+        {
+            colds[i] = *store->objs[i].cold;
+            store->objs[i].cold = &colds[i];
+        }
+        free(store->colds);
+        store->colds = colds;
+    }
+    int slot = 0;
+    for (int type = 0; type < STORE_TYPES; type++)
+    {
+        store->first[type] = slot;
+        while (slot < store->count &&
+               store->objs[slot].objtype - FIRST_TYPE == type)
+        {
+            slot++;
+        }
+    }
+    store->first[STORE_TYPES] = store->count;
+    free(store->index);
+    store->index = NULL;
+    store->span = 0;
+    if (store->count == 0)
+    {
+        return;
+    }
+    int last_id = store->objs[0].objid;
+    store->first_id = last_id;
+    for (int i = 1; i < store->count; i++)
+    {
+        int objid = store->objs[i].objid;
+        store->first_id = objid < store->first_id ? objid : store->first_id;
+        last_id = objid > last_id ? objid : last_id;
+    }
+    store->span = last_id - store->first_id + 1;
+    store->index = Malloc(sizeof(int) * (size_t)store->span);
+    for (int i = 0; i < store->span; i++)
+    {
+        store->index[i] = -1;
+    }
+    for (int i = 0; i < store->count; i++)
+    {
+        store->index[store->objs[i].objid - store->first_id] = i;
+    }
+}
+
+/*
+ * A function for looking up an object in a finished store by its id.
+ *
+ * Param: store  The store to search.
+ * Param: objid  The id of the object.
+ *
+ * Return: The object, or NULL if the store does not hold it.
+ */
+obj_t* store_find(store_t* store, int objid)
+{
+    int offset = objid - store->first_id;
+    if (offset < 0 || offset >= store->span || store->index[offset] < 0)
+    {
+        return NULL;
+    }
+    return &store->objs[store->index[offset]];
+}
+
+/*
+ * A function for finding the group of one type in a finished store.
+ *
+ * Param: store    The store to search.
+ * Param: objtype  The type of object wanted.
+ * Param: count    Output for the number of objects of that type.
+ *
+ * Return: The first object of the type. The rest follow it in the array.
+ */
+obj_t* store_type(store_t* store, int objtype, int* count)
+{
+    int type = objtype - FIRST_TYPE;
+    *count = store->first[type + 1] - store->first[type];
+    return &store->objs[store->first[type]];
+}
+
+/*
+ * A function for decomposing the store when we are done with it. The
+ * private data member of each object is freed in a single pass, and then
+ * the objects themselves are freed all at once with the arrays.
+ *
+ * Param: store  The store to be decomposed.
+ */
+void delete_store(store_t* store)
+{
+    /* List of functions pointers of object killing functions. */
+    static void (*obj_killers[])(void* obj) =
+    {
+        kill_light,
+        kill_spotlight,
+        kill_dummy,
+        kill_sphere,
+        kill_plane,
+        kill_fplane, //finite_plane
+        kill_tplane, //tiled_plane
+        kill_dummy, //tex_plane
+        kill_dummy, //ref_sphere
+        kill_sphere, //p_sphere
+        kill_plane, //pplane
+        kill_parab, //parabaloid
+        kill_cyl,
+        kill_cone,
+        kill_hyperb
+    };
+    if (!store)
+    {
+        return;
+    }
+    for (int i = 0; i < store->count; i++)
+    {
+        obj_t* obj = &store->objs[i];
+        if (obj->priv)
+        {
+            obj_killers[obj->objtype - FIRST_TYPE](obj->priv);
+        }
+    }
+    free(store->objs);
+    free(store->colds);
+    free(store->index);
+    free(store);
+}
@@ -0,0 +1,85 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * A header file for the store.c file. It includes the necessary
+ * #includes, structs, and function prototypes.
+ */
+
+/* Ensures this header file can only be included once. */
+#pragma once
+
+/* The store.c file makes use of the free functions from stdlib, and
+ * the Malloc wrapper function located in utils.c. Both are included by
+ * utils.h
+ */
+#include "utils.h"
+
+/* Includes the obj_t typedef, which are the records of our store. */
+#include "object.h"
+
+/* The following are necessary for access to their kill functions. */
+#include "light.h"
+#include "projection.h"
+#include "sphere.h"
+#include "plane.h"
+#include "pplane.h"
+#include "fplane.h"
+#include "tplane.h"
+#include "spotlight.h"
+#include "cylinder.h"
+#include "paraboloid.h"
+#include "cone.h"
+#include "hyperboloid.h"
+
+/* The number of records added before the array first has to grow. */
+#define STORE_INITIAL 16
+
+/* How many records ahead a scan asks for the private data to be fetched. */
+#define STORE_PREFETCH 2
+
+/* The number of object types, one group of records for each. */
+#define STORE_TYPES (LAST_TYPE - FIRST_TYPE + 1)
+
+/*
+ * The store_type struct, typedefed as store_t. It holds the objects
+ * themselves in one array, so that a scan walks straight through memory
+ * instead of following links across the heap. The cold half of each object
+ * is kept in a second array, in the same slot. Once store_finish is called
+ * the objects are grouped by type, each group in the order it was read, and
+ * can be looked up by their object id.
+ *
+ * Data Member: objs      The objects, grouped by type once finished.
+ * Data Member: colds     The cold half of each object in objs.
+ * Data Member: count     The number of objects in objs.
+ * Data Member: capacity  The number of objects objs has room for.
+ * Data Member: first     The slot each type's group starts at, with the
+ *                        group ending where the next type's starts.
+ * Data Member: index     The slot of each object id from first_id on, or -1
+ *                        for ids held by some other store.
+ * Data Member: first_id  The lowest object id in the store.
+ * Data Member: span      The number of entries in index.
+ */
+typedef struct store_type
+{
+    obj_t* objs;
+    obj_cold_t* colds;
+    int count;
+    int capacity;
+    int first[STORE_TYPES + 1];
+    int* index;
+    int first_id;
+    int span;
+} store_t;
+
+store_t* store_init(void);
+
+obj_t* store_add(store_t* store, obj_t* obj);
+
+void store_finish(store_t* store);
+
+obj_t* store_find(store_t* store, int objid);
+
+obj_t* store_type(store_t* store, int objtype, int* count);
+
+void delete_store(store_t* store);
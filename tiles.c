@@ -0,0 +1,177 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This file contains the multithreaded renderer. The image is cut into
+ * tiles, each worker is handed a contiguous run of them, and a worker that
+ * runs out steals single tiles from the others until none are left. Every
+ * pixel is computed by the same function the serial loop in make_image
+ * uses, so the image does not depend on the thread count.
+ */
+
+/* Header file for this source file. */
+#include "tiles.h"
+
+/*
+ * Runs the pool's pixel function over every pixel of one tile.
+ *
+ * Param: pool  The pool the tile belongs to.
+ * Param: tile  The tile to render.
+ */
+void render_tile(tile_pool_t* pool, tile_t* tile)
+{
+    for (int y = tile->y0; y < tile->y1; y++)
+    {
+        for (int x = tile->x0; x < tile->x1; x++)
+        {
+            pool->draw(pool->model, pool->image, x, y);
+        }
+    }
+}
+
+/*
+ * Takes the next tile from the owner's end of a queue.
+ * Param: queue  The worker's own queue.
+ * Return: The tile index, or -1 if the queue is empty.
+ */
+int take_tile(tile_queue_t* queue)
+{
+    int index = -1;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head < queue->tail)
+    {
+        queue->tail--;
+        index = queue->tail;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return index;
+}
+
+/*
+ * Steals a tile from the far end of another worker's queue, so the thief and
+ * the owner work on tiles that are as far apart as possible.
+ *
+ * Param: queue  The queue to steal from.
+ * Return: The tile index, or -1 if the queue is empty.
+ */
+int steal_tile(tile_queue_t* queue)
+{
+    int index = -1;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head < queue->tail)
+    {
+        index = queue->head;
+        queue->head++;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return index;
+}
+
+/*
+ * The loop run by every worker. No tiles are added once rendering starts, so
+ * a worker is finished as soon as it finds every queue empty.
+ *
+ * Param: arg  The tile_worker_t for this worker.
+ * Return: Always NULL.
+ */
+void* tile_worker(void* arg)
+{
+    tile_worker_t* worker = (tile_worker_t*)arg;
+    tile_pool_t* pool = worker->pool;
+    for (;;)
+    {
+        int index = take_tile(&pool->queues[worker->id]);
+        /* Looks through the other queues in turn, starting with the next. */
+        for (int i = 1; index < 0 && i < pool->num_workers; i++)
+        {
+            index = steal_tile(&pool->queues[(worker->id + i) %
+                                             pool->num_workers]);
+        }
+        if (index < 0)
+        {
+            stats_flush();
+            return NULL;
+        }
+        render_tile(pool, &pool->tiles[index]);
+    }
+}
+
+/*
+ * Runs a pixel function over the whole image on a number of threads. The
+ * calling thread works as the first worker.
+ *
+ * Param: model  The model being drawn.
+ * Param: draw  The function run for every pixel.
+ * Param: image  The buffer handed to draw.
+ * Param: threads  The number of threads to render with.
+ * Return: The number of allocations made while the workers were running.
+ */
+unsigned long render_tiles(model_t* model, pixel_fn_t draw, void* image,
+                           int threads)
+{
+    int width = model->proj->win_size_pixel[X];
+    int height = model->proj->win_size_pixel[Y];
+    int cols = (width + TILE_SIZE - 1) / TILE_SIZE;
+    int rows = (height + TILE_SIZE - 1) / TILE_SIZE;
+    int num_tiles = cols * rows;
+    tile_pool_t pool;
+    pool.model = model;
+    pool.draw = draw;
+    pool.image = image;
+    pool.num_workers = threads < num_tiles ? threads : num_tiles;
+    pool.tiles = Malloc(sizeof(tile_t) * (size_t)num_tiles);
+    pool.queues = Malloc(sizeof(tile_queue_t) * (size_t)pool.num_workers);
+    /* Tiles are listed row by row so each worker starts on a band. */
+    for (int i = 0; i < num_tiles; i++)
+    {
+        tile_t* tile = &pool.tiles[i];
+        tile->x0 = (i % cols) * TILE_SIZE;
+        tile->y0 = (i / cols) * TILE_SIZE;
+        tile->x1 = tile->x0 + TILE_SIZE < width ? tile->x0 + TILE_SIZE : width;
+        tile->y1 = tile->y0 + TILE_SIZE < height ? tile->y0 + TILE_SIZE
+                                                 : height;
+    }
+    /* Hands each worker an equal contiguous run of tiles. */
+    for (int i = 0; i < pool.num_workers; i++)
+    {
+        pthread_mutex_init(&pool.queues[i].lock, NULL);
+        pool.queues[i].head = (int)((long)num_tiles * i / pool.num_workers);
+        pool.queues[i].tail = (int)((long)num_tiles * (i + 1) /
+                                    pool.num_workers);
+    }
+    tile_worker_t* workers = Malloc(sizeof(tile_worker_t) *
+                                    (size_t)pool.num_workers);
+    for (int i = 0; i < pool.num_workers; i++)
+    {
+        workers[i].pool = &pool;
+        workers[i].id = i;
+    }
+    unsigned long allocs = alloc_count();
+    /* A thread that fails to start leaves its queue to be stolen from. */
+    int started = 1;
+    while (started < pool.num_workers &&
+           !pthread_create(&workers[started].thread, NULL, tile_worker,
+                           &workers[started]))
+    {
+        started++;
+    }
+    if (started < pool.num_workers)
+    {
+        fprintf(stderr, "Only %d of %d render threads could be started.\n",
+                started, pool.num_workers);
+    }
+    tile_worker(&workers[0]);
+    for (int i = 1; i < started; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+    allocs = alloc_count() - allocs;
+    for (int i = 0; i < pool.num_workers; i++)
+    {
+        pthread_mutex_destroy(&pool.queues[i].lock);
+    }
+    free(workers);
+    free(pool.queues);
+    free(pool.tiles);
+    return allocs;
+}
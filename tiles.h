@@ -0,0 +1,109 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * This is the header file for the tiles.c source file. It contains the
+ * structures used to split an image into tiles and render them on several
+ * threads, with idle threads stealing tiles from busy ones.
+ */
+
+/* Ensures this header file is only included once. */
+#pragma once
+
+/* Included for the threads and locks used by the workers. */
+#include <pthread.h>
+
+/* Includes the model_t struct that the tiles are rendered from. */
+#include "model.h"
+
+/* Includes stats_flush, called as each worker finishes. */
+#include "stats.h"
+
+/* Width and height in pixels of a single tile. */
+#define TILE_SIZE 16
+
+/*
+ * The work done for each pixel of a tile.
+ *
+ * Param: model  The model being drawn.
+ * Param: image  The buffer the pixel is written to.
+ * Param: x  The x dimension of the pixel.
+ * Param: y  The y dimension of the pixel.
+ */
+typedef void (*pixel_fn_t)(model_t* model, void* image, int x, int y);
+
+/*
+ * A rectangle of pixels rendered as one unit of work.
+ *
+ * Data Member: x0  The first column of the tile.
+ * Data Member: y0  The first row of the tile.
+ * Data Member: x1  One past the last column of the tile.
+ * Data Member: y1  One past the last row of the tile.
+ */
+typedef struct tile_type
+{
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+} tile_t;
+
+/*
+ * The tiles still owned by one worker. A worker hands out its own tiles from
+ * the tail, while other workers steal from the head.
+ *
+ * Data Member: lock  Guards head and tail.
+ * Data Member: head  The first tile index not yet taken.
+ * Data Member: tail  One past the last tile index not yet taken.
+ */
+typedef struct tile_queue_type
+{
+    pthread_mutex_t lock;
+    int head;
+    int tail;
+} tile_queue_t;
+
+/*
+ * Everything shared between the workers rendering one image.
+ *
+ * Data Member: model  The model being drawn.
+ * Data Member: draw  The function run for every pixel.
+ * Data Member: image  The buffer handed to draw.
+ * Data Member: tiles  Every tile of the image.
+ * Data Member: queues  One queue of tile indices per worker.
+ * Data Member: num_workers  The number of workers, and so of queues.
+ */
+typedef struct tile_pool_type
+{
+    model_t* model;
+    pixel_fn_t draw;
+    void* image;
+    tile_t* tiles;
+    tile_queue_t* queues;
+    int num_workers;
+} tile_pool_t;
+
+/*
+ * The argument handed to each worker thread.
+ *
+ * Data Member: pool  The pool this worker takes tiles from.
+ * Data Member: id  The index of this worker's own queue.
+ * Data Member: thread  The thread running this worker.
+ */
+typedef struct tile_worker_type
+{
+    tile_pool_t* pool;
+    int id;
+    pthread_t thread;
+} tile_worker_t;
+
+unsigned long render_tiles(model_t* model, pixel_fn_t draw, void* image,
+                           int threads);
+
+void render_tile(tile_pool_t* pool, tile_t* tile);
+
+int take_tile(tile_queue_t* queue);
+
+int steal_tile(tile_queue_t* queue);
+
+void* tile_worker(void* arg);
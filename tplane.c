@@ -17,7 +17,7 @@
  *
  * Return: The constructed tplane object.
  */
-obj_t* tplane_init(FILE* in, int objtype)
+obj_t* tplane_init(scene_in_t* in, int objtype)
 {
     obj_t* obj = fplane_init(in, objtype);
     if(obj)
@@ -34,15 +34,16 @@ obj_t* tplane_init(FILE* in, int objtype)
         }
         else
         {
-            obj->getamb = tp_amb;
-            obj->getdiff = tp_diff;
-            obj->getspec = tp_spec;
+            obj->cold->getamb = tp_amb;
+            obj->cold->getdiff = tp_diff;
+            obj->cold->getspec = tp_spec;
+            obj->cold->shade = tp_shade;
             obj->hits = hits_tplane;
 
-            double unit_norm[XYZ];
+            real_t unit_norm[XYZ];
             unitvec3(plane->normal, unit_norm);
 
-            double unit_xdir[XYZ];
+            real_t unit_xdir[XYZ];
             unitvec3(fplane->xdir, unit_xdir);
 
             projection(unit_xdir, unit_norm, unit_xdir);
@@ -60,18 +61,18 @@ obj_t* tplane_init(FILE* in, int objtype)
 
 /*
  * This function selects which tile color we have landed on.
- * Param: obj  The object who's hitlocation we need to analyze.
+ * Param: obj  The object that was hit.
+ * Param: hit  The hit who's hitlocation we need to analyze.
  * Return: 0 or 1, alternating by tile.
  */
-int tp_select(obj_t* obj)
+int tp_select(obj_t* obj, hit_t* hit)
 {
     plane_t* plane = (plane_t*)obj->priv;
     fplane_t* fp = (fplane_t*)plane->priv;
-    double newhit[XYZ];
-    diff3(plane->point, obj->hitloc, newhit);
-    transform(fp->rotmat, newhit, newhit);
-    int relx = (int)((10000 + newhit[X]) / fp->size[X]);
-    int rely = (int)((10000 + newhit[Y]) / fp->size[Y]);
+    vec3_t newhit = vec3_xform(fp->rotmat, vec3_sub(vec3_load(hit->hitloc),
+                                                    vec3_load(plane->point)));
+    int relx = (int)((10000 + newhit.x) / fp->size[X]);
+    int rely = (int)((10000 + newhit.y) / fp->size[Y]);
     return ((relx + rely) & 1);
 }
 
@@ -80,16 +81,17 @@ int tp_select(obj_t* obj)
  * lighting on a tiled plane. 
  *
  * Param: obj The object that we are changing the light intensity on.
+ * Param: hit The hit on obj that is being lit.
  * Param: value  The intensity vector that we are altering.
  */
-void tp_diff(obj_t* obj, double* value)
+void tp_diff(obj_t* obj, hit_t* hit, real_t* value)
 {
     plane_t* pln = (plane_t*)obj->priv;
     fplane_t* fp = (fplane_t*)pln->priv;
     tplane_t* tp = (tplane_t*)fp->priv;
-    if(tp_select(obj))
+    if(tp_select(obj, hit))
     {
-        copy3(obj->material.diffuse, value);
+        copy3(obj->cold->material.diffuse, value);
     }
     else
     {
@@ -102,16 +104,17 @@ void tp_diff(obj_t* obj, double* value)
  * lighting on a tiled plane. 
  *
  * Param: obj The object that we are changing the light intensity on.
+ * Param: hit The hit on obj that is being lit.
  * Param: value  The intensity vector that we are altering.
  */
-void tp_amb(obj_t* obj, double* value)
+void tp_amb(obj_t* obj, hit_t* hit, real_t* value)
 {
     plane_t* pln = (plane_t*)obj->priv;
     fplane_t* fpln = (fplane_t*)pln->priv;
     tplane_t* tp = (tplane_t*)fpln->priv;
-    if(tp_select(obj))
+    if(tp_select(obj, hit))
     {
-        copy3(obj->material.ambient, value);
+        copy3(obj->cold->material.ambient, value);
     }
     else
     {
@@ -124,16 +127,17 @@ void tp_amb(obj_t* obj, double* value)
  * lighting on a tiled plane. 
  *
  * Param: obj The object that we are changing the light intensity on.
+ * Param: hit The hit on obj that is being lit.
  * Param: value  The intensity vector that we are altering.
  */
-void tp_spec(obj_t* obj, double* value)
+void tp_spec(obj_t* obj, hit_t* hit, real_t* value)
 {
     plane_t* pln = (plane_t*)obj->priv;
     fplane_t* fpln = (fplane_t*)pln->priv;
     tplane_t* tp = (tplane_t*)fpln->priv;
-    if(tp_select(obj))
+    if(tp_select(obj, hit))
     {
-        copy3(obj->material.specular, value);
+        copy3(obj->cold->material.specular, value);
     }
     else
     {
@@ -141,9 +145,31 @@ void tp_spec(obj_t* obj, double* value)
     }
 }
 
-double hits_tplane(double* base, double* dir, obj_t* obj)
+/*
+ * This function fills in the shading record for a hit on a tiled plane. The
+ * tile is selected once, and all three parts of the material are taken from
+ * it.
+ *
+ * Param: obj  The object that was hit.
+ * Param: hit  The hit being shaded.
+ * Param: shade  The output shading record.
+ */
+void tp_shade(obj_t* obj, hit_t* hit, shade_t* shade)
+{
+    plane_t* pln = (plane_t*)obj->priv;
+    fplane_t* fpln = (fplane_t*)pln->priv;
+    tplane_t* tp = (tplane_t*)fpln->priv;
+    material_t* material = tp_select(obj, hit) ? &obj->cold->material
+                                               : &tp->background;
+    copy3(material->ambient, shade->ambient);
+    copy3(material->diffuse, shade->diffuse);
+    copy3(material->specular, shade->specular);
+    vec3_store(vec3_unit(vec3_load(hit->normal)), shade->normal);
+}
+
+real_t hits_tplane(real_t* base, real_t* dir, obj_t* obj)
 {
-    double t = hits_plane(base, dir, obj);
+    real_t t = hits_plane(base, dir, obj);
     return t;
 }
 
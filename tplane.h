@@ -27,20 +27,22 @@ typedef struct
     material_t background;
 } tplane_t;
 
-obj_t* tplane_init(FILE* in, int objtype);
+obj_t* tplane_init(scene_in_t* in, int objtype);
 
 void kill_tplane(void* tplane);
 
-double hits_tplane(double* base, double* dir, obj_t* obj);
+real_t hits_tplane(real_t* base, real_t* dir, obj_t* obj);
 
 void kill_tplane(void* tplane);
 
-void tp_spec(obj_t* obj, double* value);
+void tp_spec(obj_t* obj, hit_t* hit, real_t* value);
 
-void tp_amb(obj_t* obj, double* value);
+void tp_amb(obj_t* obj, hit_t* hit, real_t* value);
 
-void tp_diff(obj_t* obj, double* value);
+void tp_diff(obj_t* obj, hit_t* hit, real_t* value);
 
-int tp_select(obj_t* obj);
+int tp_select(obj_t* obj, hit_t* hit);
+
+void tp_shade(obj_t* obj, hit_t* hit, shade_t* shade);
 
 void dump_tplane(FILE* out, obj_t* obj);
@@ -11,6 +11,10 @@
  * file. */
 #include "utils.h"
 
+/* The number of allocations made through Malloc, Calloc and Realloc so far.
+ * It is updated atomically so render threads may allocate safely. */
+static unsigned long allocations = 0;
+
 /*
  * A wrapper function for the malloc function in stdlib. It will catch a null
  * return from malloc indicating that there was a problem aquiring the 
@@ -25,6 +29,7 @@
 void* Malloc(size_t size)
 {
     void* address = malloc(size);
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
     if (NULL == address)
     {
         fprintf(stderr, "Unable to aquire memory of size %zd. Now exiting...\n",
@@ -34,6 +39,40 @@ void* Malloc(size_t size)
     return address;
 }
 
+/*
+ * A wrapper function for the realloc function in stdlib. Like Malloc, it
+ * exits with error instead of returning NULL, and it counts as an allocation.
+ *
+ * Param: address  The memory to resize, or NULL for new memory.
+ * Param: size     The amount (in bytes) of memory wanted.
+ *
+ * Return: address The resized memory, which may have moved.
+ */
+void* Realloc(void* address, size_t size)
+{
+    address = realloc(address, size);
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    if (NULL == address)
+    {
+        fprintf(stderr, "Unable to aquire memory of size %zd. Now exiting...\n",
+                size);
+        exit(EXIT_FAILURE);
+    }
+    return address;
+}
+
+/*
+ * Reports how many allocations have been made through the wrappers. The
+ * renderer checks this before and after drawing to show that no memory is
+ * requested per pixel.
+ *
+ * Return: The number of allocations made since the program started.
+ */
+unsigned long alloc_count(void)
+{
+    return __atomic_load_n(&allocations, __ATOMIC_RELAXED);
+}
+
 /*
  * A wrapper function for the malloc function in stdlib. It will catch a null
  * return from calloc indicating that there was a problem aquiring the 
@@ -49,6 +88,7 @@ void* Malloc(size_t size)
 void* Calloc(int spaces, size_t size)
 {
     void* address = calloc((size_t)spaces, size);
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
     if (NULL == address)
     {
         fprintf(stderr, "Unable to aquire memory of size %zd. Now exiting...\n",
@@ -79,19 +119,3 @@ int is_light(int objtype)
     }
     return boolean;
 }
-
-/*
- * Reads in one number from file input. We will only succeed
- * if we read exactly one item.
- *
- * Param: in  The file to read from.
- * Param: ndx The output double to store the value in.
- * Return: pcount  The number of objects read in. Only one is success.
- */
-int vec_get1(FILE* in, double* ndx)
-{
-    char buff[BUFF_SIZE];
-    int pcount = fscanf(in, "%lf", ndx);
-    fgets(buff, BUFF_SIZE, in);
-    return pcount;
-}
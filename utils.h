@@ -15,6 +15,29 @@
 /* Include for the use of the malloc and calloc functions. */
 #include <stdlib.h>
 
+/* Included for the machine epsilon of each floating point type. */
+#include <float.h>
+
+/*
+ * The floating point type that geometry and shading are done in. It is a
+ * double unless the tracer is built with -DSINGLE_PRECISION, which the single
+ * target in the Makefile does.
+ *
+ * SCN_REAL is the scanf conversion for a real_t, REAL_EPSILON is the gap
+ * between 1 and the next real_t above it, and REAL_NAME names the precision.
+ */
+#ifdef SINGLE_PRECISION
+typedef float real_t;
+#define SCN_REAL "%f"
+#define REAL_EPSILON FLT_EPSILON
+#define REAL_NAME "single"
+#else
+typedef double real_t;
+#define SCN_REAL "%lf"
+#define REAL_EPSILON DBL_EPSILON
+#define REAL_NAME "double"
+#endif
+
 /* Our enumeration of our objects. */
 #define FIRST_TYPE   10
 #define LIGHT        10
@@ -45,6 +68,8 @@ void* Malloc(size_t size);
 
 void* Calloc(int spaces, size_t size);
 
-int is_light(int objtype);
+void* Realloc(void* address, size_t size);
 
-int vec_get1(FILE* in, double* ndx);
+unsigned long alloc_count(void);
+
+int is_light(int objtype);
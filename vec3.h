@@ -0,0 +1,199 @@
+/*
+ * Author: Tyler Allen
+ * Date: 10/18/2026
+ *
+ * A three component vector that is passed and returned by value, with every
+ * operation defined inline in this header. Since the operations are visible
+ * in every file that uses them, the compiler can inline them, keep the
+ * components in registers and vectorize across calls, which it cannot do
+ * with the out parameters of the functions in veclib.c. Each operation does
+ * its arithmetic in the same order as the veclib.c function it replaces.
+ */
+
+/* Ensures this header file is only included once. */
+#pragma once
+
+/* Includes the real_t type. */
+#include "utils.h"
+
+/* Included for sqrt. */
+#include <tgmath.h>
+
+/* Number of dimensions in a vec3_t, and the rows of a rotation matrix. */
+#define XYZ 3
+
+/*
+ * A vector in three dimensions.
+ *
+ * Data Member: x  The x component.
+ * Data Member: y  The y component.
+ * Data Member: z  The z component.
+ */
+typedef struct vec3_type
+{
+    real_t x;
+    real_t y;
+    real_t z;
+} vec3_t;
+
+/*
+ * Builds a vector from its components.
+ *
+ * Param: x  The x component.
+ * Param: y  The y component.
+ * Param: z  The z component.
+ *
+ * Return: The vector.
+ */
+static inline vec3_t vec3(real_t x, real_t y, real_t z)
+{
+    vec3_t v = {x, y, z};
+    return v;
+}
+
+/*
+ * Reads a vector out of a three element array.
+ *
+ * Param: a  The array to read.
+ * Return: The vector.
+ */
+static inline vec3_t vec3_load(const real_t* a)
+{
+    return vec3(a[0], a[1], a[2]);
+}
+
+/*
+ * Writes a vector into a three element array.
+ *
+ * Param: v  The vector to write.
+ * Param: a  The array to write to.
+ */
+static inline void vec3_store(vec3_t v, real_t* a)
+{
+    a[0] = v.x;
+    a[1] = v.y;
+    a[2] = v.z;
+}
+
+/*
+ * Adds two vectors.
+ *
+ * Param: a  The first vector.
+ * Param: b  The second vector.
+ *
+ * Return: a + b.
+ */
+static inline vec3_t vec3_add(vec3_t a, vec3_t b)
+{
+    return vec3(a.x + b.x, a.y + b.y, a.z + b.z);
+}
+
+/*
+ * Subtracts one vector from another.
+ *
+ * Param: a  The vector to subtract from.
+ * Param: b  The vector to subtract.
+ *
+ * Return: a - b.
+ */
+static inline vec3_t vec3_sub(vec3_t a, vec3_t b)
+{
+    return vec3(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+/*
+ * Scales a vector.
+ *
+ * Param: v  The vector to scale.
+ * Param: s  The factor to scale by.
+ *
+ * Return: v * s.
+ */
+static inline vec3_t vec3_scale(vec3_t v, real_t s)
+{
+    return vec3(v.x * s, v.y * s, v.z * s);
+}
+
+/*
+ * Finds the point a distance along a ray.
+ *
+ * Param: base  The start of the ray.
+ * Param: d     The direction of the ray.
+ * Param: t     The distance, in multiples of d.
+ *
+ * Return: base + d * t.
+ */
+static inline vec3_t vec3_along(vec3_t base, vec3_t d, real_t t)
+{
+    return vec3_add(base, vec3_scale(d, t));
+}
+
+/*
+ * Finds the dot product of two vectors.
+ *
+ * Param: a  The first vector.
+ * Param: b  The second vector.
+ *
+ * Return: The dot product.
+ */
+static inline real_t vec3_dot(vec3_t a, vec3_t b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+/*
+ * Finds the length of a vector.
+ *
+ * Param: v  The vector.
+ * Return: The length of v.
+ */
+static inline real_t vec3_length(vec3_t v)
+{
+    return sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+}
+
+/*
+ * Finds the unit vector in the direction of a vector.
+ *
+ * Param: v  The vector.
+ * Return: The unit vector, or a zero vector if v has no length.
+ */
+static inline vec3_t vec3_unit(vec3_t v)
+{
+    real_t length = vec3_length(v);
+    if (length)
+    {
+        return vec3_scale(v, 1 / length);
+    }
+    return vec3(0, 0, 0);
+}
+
+/*
+ * Reflects a direction about a normal.
+ *
+ * Param: in      The unit direction of the incoming ray.
+ * Param: normal  The surface normal, which need not be a unit vector.
+ *
+ * Return: The unit direction of the reflected ray.
+ */
+static inline vec3_t vec3_reflect(vec3_t in, vec3_t normal)
+{
+    vec3_t u = vec3_scale(in, -1);
+    vec3_t n = vec3_unit(normal);
+    return vec3_unit(vec3_sub(vec3_scale(n, 2 * vec3_dot(u, n)), u));
+}
+
+/*
+ * Multiplies a vector by a rotation matrix.
+ *
+ * Param: mat  The matrix, by rows.
+ * Param: v    The vector.
+ *
+ * Return: mat * v.
+ */
+static inline vec3_t vec3_xform(real_t mat[XYZ][XYZ], vec3_t v)
+{
+    return vec3(mat[0][0] * v.x + mat[0][1] * v.y + mat[0][2] * v.z,
+                mat[1][0] * v.x + mat[1][1] * v.y + mat[1][2] * v.z,
+                mat[2][0] * v.x + mat[2][1] * v.y + mat[2][2] * v.z);
+}
@@ -2,7 +2,9 @@
  * Author: Tyler Allen
  * Date: 03/05/13
  *
- * A library of vector functions for use in the ray tracer.
+ * A library of vector functions for use in the ray tracer. These take arrays
+ * and out parameters, and are kept as wrappers around the inline vec3_t
+ * operations in vec3.h for code that still works on arrays.
  *
  * Note: This file must be compiled with -lm.
  */
@@ -18,11 +20,9 @@
  * 
  * Returns: The final dot product.
  */
-double dot3 (double* vec1, double* vec2)
+real_t dot3 (real_t* vec1, real_t* vec2)
 {
-    return vec1[X] * vec2[X] + 
-           vec1[Y] * vec2[Y] + 
-           vec1[Z] * vec2[Z];
+    return vec3_dot(vec3_load(vec1), vec3_load(vec2));
 }
 
 /*
@@ -33,11 +33,9 @@ double dot3 (double* vec1, double* vec2)
  * Param: input_vector  The vector to be scaled.
  * Param: output_vector The vector to store the new output vector in.
  */
-void scale3 (double scale_factor, double* input_vec, double* output_vec)
+void scale3 (real_t scale_factor, real_t* input_vec, real_t* output_vec)
 {
-    output_vec[X] = input_vec[X] * scale_factor;
-    output_vec[Y] = input_vec[Y] * scale_factor;
-    output_vec[Z] = input_vec[Z] * scale_factor;
+    vec3_store(vec3_scale(vec3_load(input_vec), scale_factor), output_vec);
 }
 
 /*
@@ -47,11 +45,9 @@ void scale3 (double scale_factor, double* input_vec, double* output_vec)
  * 
  * Return: The calculated length of vec1.
  */
-double length3 (double* vec1)
+real_t length3 (real_t* vec1)
 {
-    return sqrt(pow(vec1[X], SQUARED) + 
-                pow(vec1[Y], SQUARED) + 
-                pow(vec1[Z], SQUARED));
+    return vec3_length(vec3_load(vec1));
 }
 
 
@@ -62,11 +58,9 @@ double length3 (double* vec1)
  * Param: v2  The vector to subtract from.
  * Param: v3  The vector to store the new vector in.
  */
-void diff3 (double* v1, double* v2, double* v3)
+void diff3 (real_t* v1, real_t* v2, real_t* v3)
 {
-    v3[X] = v2[X] - v1[X];
-    v3[Y] = v2[Y] - v1[Y];
-    v3[Z] = v2[Z] - v1[Z];
+    vec3_store(vec3_sub(vec3_load(v2), vec3_load(v1)), v3);
 }
 
 /*
@@ -76,11 +70,9 @@ void diff3 (double* v1, double* v2, double* v3)
  * Param: v2  The second vector to add.
  * Param: v3  The vector to store the sum of v1 and v2 in.
  */
-void sum3 (double* v1, double* v2, double* v3)
+void sum3 (real_t* v1, real_t* v2, real_t* v3)
 {
-    v3[X] = v2[X] + v1[X];
-    v3[Y] = v2[Y] + v1[Y];
-    v3[Z] = v2[Z] + v1[Z];
+    vec3_store(vec3_add(vec3_load(v2), vec3_load(v1)), v3);
 }
 
 /*
@@ -90,22 +82,9 @@ void sum3 (double* v1, double* v2, double* v3)
  * Param: v1  The vector to find the unit vector of.
  * Param: v2  The vector to store the unit vector in.
  */
-void unitvec3 (double* v1, double* v2)
+void unitvec3 (real_t* v1, real_t* v2)
 {
-    double scalar = length3(v1);
-    if (scalar)
-    {
-        scalar = ONE/scalar;
-        v2[X] = v1[X] * scalar;
-        v2[Y] = v1[Y] * scalar;
-        v2[Z] = v1[Z] * scalar;
-    }
-    else
-    {
-        v2[X] = ZERO;
-        v2[Y] = ZERO;
-        v2[Z] = ZERO;
-    }
+    vec3_store(vec3_unit(vec3_load(v1)), v2);
 }
 
 /*
@@ -114,17 +93,9 @@ void unitvec3 (double* v1, double* v2)
  * unitout - unit vector in direction of bounce
  */
 
-void reflect3 (double* unitin, double* unitnorm, double* unitout)
+void reflect3 (real_t* unitin, real_t* unitnorm, real_t* unitout)
 {
-    double U[XYZ];
-    scale3(-1, unitin, U);
-    double N[XYZ];
-    copy3(unitnorm, N);
-    unitvec3(N, N); 
-    double big_N[XYZ];
-    scale3(2 * dot3(U, N), N, big_N);
-    diff3(U, big_N, unitout);
-    unitvec3(unitout, unitout);
+    vec3_store(vec3_reflect(vec3_load(unitin), vec3_load(unitnorm)), unitout);
 }
 
 /*
@@ -134,7 +105,7 @@ void reflect3 (double* unitin, double* unitnorm, double* unitout)
  * Param: vec1  Input vector to copy.
  * Param: vec2  Output vector to copy to.
  */
-void copy3(double* vec1, double* vec2)
+void copy3(real_t* vec1, real_t* vec2)
 {
     vec2[X] = vec1[X];
     vec2[Y] = vec1[Y];
@@ -150,7 +121,7 @@ void copy3(double* vec1, double* vec2)
  * Param: vector  The vector to be printed.
  * Param: vector_size  The size of the vector that is being printed.
  */
-void vecprnN (char* label, double* vector, int vector_size)
+void vecprnN (char* label, real_t* vector, int vector_size)
 {
     int i;
     fprintf (stderr, "%s\n", label);
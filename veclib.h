@@ -16,7 +16,10 @@
 #include "utils.h"
 
 /* Included for standard math functions (sqrt and pow). */
-#include <math.h>
+#include <tgmath.h>
+
+/* Includes the vec3_t type, whose inline operations these functions wrap. */
+#include "vec3.h"
 
 /* Index of the x dimension. */
 #define X 0
@@ -28,7 +31,7 @@
 #define Z 2
 
 /* Power for use in difference formula. */
-#define SQUARED 2
+#define SQUARED 2.0
 
 /* Zero, used usually when a vector of zero is sent in to prevent divide by
  * zero errors. 
@@ -41,20 +44,20 @@
 /* Number of dimensions in XYZ, 3 */
 #define XYZ 3
 
-double dot3 (double* vec1, double* vec2);
+real_t dot3 (real_t* vec1, real_t* vec2);
 
-void scale3 (double scale_factor, double* input_vec, double* output_vec);
+void scale3 (real_t scale_factor, real_t* input_vec, real_t* output_vec);
 
-double length3 (double* vector);
+real_t length3 (real_t* vector);
 
-void diff3 (double* v1, double* v2, double* v3);
+void diff3 (real_t* v1, real_t* v2, real_t* v3);
 
-void sum3 (double* v1, double* v2, double* v3);
+void sum3 (real_t* v1, real_t* v2, real_t* v3);
 
-void unitvec3 (double* v1, double* v2);
+void unitvec3 (real_t* v1, real_t* v2);
 
-void reflect3 (double* unitin, double* unitnorm, double* unitout);
+void reflect3 (real_t* unitin, real_t* unitnorm, real_t* unitout);
 
-void copy3(double* v1, double* v2);
+void copy3(real_t* v1, real_t* v2);
 
-void vecprnN (char* label, double* vector, int vector_size);
+void vecprnN (char* label, real_t* vector, int vector_size);